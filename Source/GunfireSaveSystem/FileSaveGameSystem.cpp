@@ -0,0 +1,655 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "FileSaveGameSystem.h"
+
+#if USE_FILE_SAVEGAMESYSTEM
+
+#include "PersistenceDelta.h"
+#include "PersistenceIOEngine.h"
+#include "PersistenceSaveData.h"
+#include "PersistenceUtils.h"
+#include "WindowsSaveGameSystem.h"
+
+#include "HAL/FileManagerGeneric.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PathViews.h"
+
+#if PLATFORM_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if PLATFORM_LINUX
+#include <sys/ioctl.h>
+
+// From <linux/fs.h>, which the toolchain's sysroot may be too old to have
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
+TAutoConsoleVariable<bool> CVarPersistenceLinkBackups(TEXT("SaveSystem.LinkBackups"), true, TEXT("Makes the first backup of a save a hard link to it (or a clone, on file systems that support it) instead of a copy"));
+TAutoConsoleVariable<bool> CVarPersistenceDeltaBackups(TEXT("SaveSystem.DeltaBackups"), false, TEXT("Stores backups older than the first one as deltas against the next newer backup"));
+TAutoConsoleVariable<int32> CVarPersistenceFlushSaves(TEXT("SaveSystem.FlushSaves"), 1, TEXT("How hard to try to get saves onto storage before they replace the old save. 0 leaves it up to the OS, 1 flushes the new save file, 2 also flushes the directory so the replace survives a power outage (only on platforms that support it)"));
+
+FFileSaveGameSystem& FFileSaveGameSystem::Get()
+{
+#if USE_WINDOWS_SAVEGAMESYSTEM
+	return FWindowsSaveGameSystem::Get();
+#else
+	static FFileSaveGameSystem System;
+	return System;
+#endif
+}
+
+FFileSaveGameSystem::FFileSaveGameSystem()
+{
+	SavedGamesDir = FString::Printf(TEXT("%sSaveGames"), *FPaths::ProjectSavedDir());
+}
+
+void FFileSaveGameSystem::SetUserFolder(const FStringView& UserFolderIn)
+{
+	UserFolder = UserFolderIn;
+}
+
+void FFileSaveGameSystem::SetBackupSettings(int32 NumBackupsIn, double BackupIntervalSecondsIn)
+{
+	NumBackups = NumBackupsIn;
+	BackupIntervalSeconds = BackupIntervalSecondsIn;
+}
+
+bool FFileSaveGameSystem::DoesBackupExist(const TCHAR* Name) const
+{
+	TStringBuilder<MAX_PATH> SavePath, BackupPath;
+
+	GetSaveGamePath(Name, SavePath);
+	const FStringView BasePath = FPathViews::GetBaseFilenameWithPath(SavePath);
+
+	for (int32 i = 1; i <= NumBackups; ++i)
+	{
+		GetBackupSaveGamePath(BasePath, i, BackupPath);
+
+		const bool bBackupExists = IFileManager::Get().FileExists(*BackupPath);
+		if (bBackupExists)
+		{
+			return true;
+		}
+
+		GetDeltaBackupSaveGamePath(BasePath, i, BackupPath);
+
+		if (IFileManager::Get().FileExists(*BackupPath))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FFileSaveGameSystem::RestoreBackup(const TCHAR* Name) const
+{
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+	TStringBuilder<MAX_PATH> SavePath, DestPath, SrcPath;
+
+	GetSaveGamePath(Name, SavePath);
+	const FStringView BasePath = FPathViews::GetBaseFilenameWithPath(SavePath);
+
+	// If we are restoring then something has gone wrong with the current save. Just rename it, prior to restoring a
+	// backup, to signify that it is corrupt. This way it can potentially be evaluated by the dev team later on.
+	if (PlatformFile.FileExists(*SavePath))
+	{
+		const FDateTime ModDateTime = FFileManagerGeneric::Get().GetTimeStamp(*SavePath);
+
+		DestPath.Appendf(TEXT("%s_%s.corrupt"), *SavePath, *ModDateTime.ToString());
+
+		PlatformFile.MoveFile(*DestPath, *SavePath);
+	}
+
+	ExpandDeltaBackups(BasePath);
+
+	// Keep track of our destination in case there are missing backups. For example, if bak1 is missing but bak2 and
+	// bak3 are available, this will ensure that bak2 becomes the main save and bak3 is put in the bak1 slot.
+	int32 DestRevision = 0;
+	bool bResult = false;
+
+	for (int32 i = 1; i <= NumBackups; ++i)
+	{
+		if (DestRevision == 0)
+		{
+			DestPath = SavePath.GetData();
+		}
+		else
+		{
+			GetBackupSaveGamePath(BasePath, DestRevision, DestPath);
+		}
+
+		GetBackupSaveGamePath(BasePath, i, SrcPath);
+
+		if (PlatformFile.FileExists(*SrcPath))
+		{
+			const bool bFileMoved = ReplaceSaveFile(*DestPath, *SrcPath);
+
+			// If we are overwriting the active save, store the result.
+			if (DestRevision == 0)
+			{
+				bResult = bFileMoved;
+			}
+
+			DestRevision++;
+		}
+	}
+
+	return bResult;
+}
+
+ISaveGameSystem::ESaveExistsResult FFileSaveGameSystem::DoesSaveGameExistWithResult(const TCHAR* Name, const int32 UserIndex, bool& bRestoredFromBackup)
+{
+	ESaveExistsResult Result;
+
+	bRestoredFromBackup = false;
+
+	do
+	{
+		Result = FGenericSaveGameSystem::DoesSaveGameExistWithResult(Name, UserIndex);
+
+		// If the save game is corrupt, attempt to restore a backup and try again.
+		if (Result == ESaveExistsResult::Corrupt && RestoreBackup(Name))
+		{
+			bRestoredFromBackup = true;
+		}
+		else
+		{
+			break;
+		}
+	}
+	while (bRestoredFromBackup);
+
+	// If we've successfully loaded a backup, mark the result as 'Restored'.
+	if (bRestoredFromBackup && Result == ESaveExistsResult::OK)
+	{
+		bRestoredFromBackup = true;
+	}
+
+	return Result;
+}
+
+ISaveGameSystem::ESaveExistsResult FFileSaveGameSystem::DoesSaveGameExistWithResult(const TCHAR* Name, const int32 UserIndex)
+{
+	bool bRestoredFromBackup;
+	return DoesSaveGameExistWithResult(Name, UserIndex, bRestoredFromBackup);
+}
+
+bool FFileSaveGameSystem::SaveGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, const TArray<uint8>& Data)
+{
+	return SaveGames({ FSaveRequest{ Name, &Data } }, UserIndex);
+}
+
+bool FFileSaveGameSystem::SaveGames(TConstArrayView<FSaveRequest> Saves, const int32 UserIndex)
+{
+	TArray<FString, TInlineAllocator<2>> SavePaths;
+	TArray<FPersistenceIORequest, TInlineAllocator<2>> Requests;
+
+	for (const FSaveRequest& Save : Saves)
+	{
+		const FString& SavePath = SavePaths.Add_GetRef(GetSaveGamePath(Save.Name));
+
+		// Make sure the data is actually on storage before the file is moved over the old save, otherwise the move can
+		// land before the data does and a power outage would leave us with a truncated save.
+		FPersistenceIORequest& Request = Requests.AddDefaulted_GetRef();
+		Request.Type = FPersistenceIORequest::EType::Write;
+		Request.Path = FString(FPathViews::GetBaseFilenameWithPath(SavePath)) + TEXT(".tmp");
+		Request.WriteData = *Save.Data;
+		Request.bFlush = GetFlushMode() >= 1;
+	}
+
+	// First, write the saves to temp files. This lessens the risk of a freak power outage or crash catching us with
+	// partially written data.
+	if (!FPersistenceIOEngine::Get().Execute(Requests))
+	{
+		IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+
+		for (const FPersistenceIORequest& Request : Requests)
+		{
+			PlatformFile.DeleteFile(*Request.Path);
+		}
+
+		return false;
+	}
+
+	bool bResult = true;
+
+	for (int32 i = 0; i < Saves.Num(); i++)
+	{
+		const FStringView BasePath = FPathViews::GetBaseFilenameWithPath(SavePaths[i]);
+
+		// Before we overwrite our current save, give the backup function a chance to back it up
+		RotateBackups(Saves[i].Name, BasePath, SavePaths[i]);
+
+		// Move the new save from the temp file to the final location
+		if (ReplaceSaveFile(*SavePaths[i], *Requests[i].Path))
+		{
+			if (GetFlushMode() >= 2)
+			{
+				FlushDirectory(FPathViews::GetPath(SavePaths[i]));
+			}
+		}
+		else
+		{
+			bResult = false;
+		}
+	}
+
+	return bResult;
+}
+
+bool FFileSaveGameSystem::CopySaveGame(const TCHAR* SrcName, const TCHAR* DestName)
+{
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+
+	const FString SrcPath = GetSaveGamePath(SrcName);
+	const FString DestPath = GetSaveGamePath(DestName);
+
+	if (!PlatformFile.FileExists(*SrcPath))
+	{
+		return false;
+	}
+
+	const FStringView BasePath = FPathViews::GetBaseFilenameWithPath(DestPath);
+	const FString TempPath = FString(BasePath) + TEXT(".tmp");
+
+	// Links can't be made over an existing file, and this could be left over from a failed save
+	if (PlatformFile.FileExists(*TempPath))
+	{
+		PlatformFile.DeleteFile(*TempPath);
+	}
+
+	// Copy to a temp file and move it over the old save like any other save, so a failure can't leave a partial copy
+	if (!CloneSaveFile(*TempPath, *SrcPath))
+	{
+		PlatformFile.DeleteFile(*TempPath);
+		return false;
+	}
+
+	RotateBackups(DestName, BasePath, DestPath);
+
+	// The temp file may be a link to the source save, so it can't be left around for a later save to write through
+	if (!ReplaceSaveFile(*DestPath, *TempPath))
+	{
+		PlatformFile.DeleteFile(*TempPath);
+		return false;
+	}
+
+	if (GetFlushMode() >= 2)
+	{
+		FlushDirectory(FPathViews::GetPath(DestPath));
+	}
+
+	return true;
+}
+
+bool FFileSaveGameSystem::LoadGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, TArray<uint8>& Data)
+{
+	FPersistenceIORequest Request;
+	Request.Type = FPersistenceIORequest::EType::Read;
+	Request.Path = GetSaveGamePath(Name);
+	Request.ReadData = &Data;
+
+	return FPersistenceIOEngine::Get().Execute(MakeArrayView(&Request, 1));
+}
+
+TSharedPtr<FPersistenceSaveData> FFileSaveGameSystem::MapSaveGame(const TCHAR* Name)
+{
+	if (!CanMapSaves())
+	{
+		return nullptr;
+	}
+
+	return FPersistenceSaveData::MapFile(*GetSaveGamePath(Name));
+}
+
+bool FFileSaveGameSystem::ReplaceSaveFile(const TCHAR* DestPath, const TCHAR* SrcPath) const
+{
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+
+	if (PlatformFile.MoveFile(DestPath, SrcPath))
+	{
+		return true;
+	}
+
+	// Some platforms won't move over an existing file. Delete it and try again, there will be a short window where
+	// there's no save but the temp file will still be around.
+	if (PlatformFile.FileExists(DestPath))
+	{
+		PlatformFile.DeleteFile(DestPath);
+	}
+
+	return PlatformFile.MoveFile(DestPath, SrcPath);
+}
+
+int32 FFileSaveGameSystem::GetFlushMode()
+{
+	return CVarPersistenceFlushSaves.GetValueOnAnyThread();
+}
+
+bool FFileSaveGameSystem::UseLinkedBackups()
+{
+	return CVarPersistenceLinkBackups.GetValueOnAnyThread();
+}
+
+bool FFileSaveGameSystem::UseDeltaBackups()
+{
+	return CVarPersistenceDeltaBackups.GetValueOnAnyThread();
+}
+
+bool FFileSaveGameSystem::CloneSaveFile(const TCHAR* DestPath, const TCHAR* SrcPath) const
+{
+#if PLATFORM_UNIX
+	if (UseLinkedBackups())
+	{
+		const FString FullSrcPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(SrcPath);
+		const FString FullDestPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(DestPath);
+
+#if PLATFORM_LINUX
+		// A reflink is an independent copy that shares storage with the original, on file systems that support it
+		// (btrfs, XFS). That's better than a hard link, since damage to one file can't affect the other.
+		const int Src = open(TCHAR_TO_UTF8(*FullSrcPath), O_RDONLY | O_CLOEXEC);
+		if (Src >= 0)
+		{
+			bool bCloned = false;
+
+			// Clone into a new file, since an old one could be linked to another save
+			unlink(TCHAR_TO_UTF8(*FullDestPath));
+			const int Dest = open(TCHAR_TO_UTF8(*FullDestPath), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+			if (Dest >= 0)
+			{
+				bCloned = ioctl(Dest, FICLONE, Src) == 0;
+				close(Dest);
+
+				if (!bCloned)
+				{
+					unlink(TCHAR_TO_UTF8(*FullDestPath));
+				}
+			}
+
+			close(Src);
+
+			if (bCloned)
+			{
+				return true;
+			}
+		}
+#endif
+
+		if (link(TCHAR_TO_UTF8(*FullSrcPath), TCHAR_TO_UTF8(*FullDestPath)) == 0)
+		{
+			return true;
+		}
+	}
+#endif
+
+	return IPlatformFile::GetPlatformPhysical().CopyFile(DestPath, SrcPath);
+}
+
+void FFileSaveGameSystem::FlushDirectory(const FStringView& Path)
+{
+#if PLATFORM_UNIX
+	const FString FullPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*FString(Path));
+
+	const int Directory = open(TCHAR_TO_UTF8(*FullPath), O_RDONLY | O_DIRECTORY);
+	if (Directory >= 0)
+	{
+		fsync(Directory);
+		close(Directory);
+	}
+#endif
+}
+
+void FFileSaveGameSystem::RotateBackups(const TCHAR* Name, const FStringView BasePath, const FStringView SavePath)
+{
+	// If we're not backing up saves we're done
+	if (NumBackups <= 0)
+	{
+		return;
+	}
+
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	double* LastTime = LastBackupTime.Find(Name);
+
+	// If this is the first time we've saved don't do backups. That way if someone is starting and shutting down the
+	// game a bunch they won't wipe all their backups. We wait until they've been playing for our backup interval before
+	// doing our first rotation.
+	if (LastTime == nullptr)
+	{
+		LastBackupTime.Add(Name, CurrentTime);
+		return;
+	}
+
+	// If our backup interval hasn't passed since the last save, don't rotate
+	if (*LastTime + BackupIntervalSeconds > CurrentTime)
+	{
+		return;
+	}
+
+	*LastTime = CurrentTime;
+
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+	TStringBuilder<MAX_PATH> CurrentBackupPath, NextBackupPath, CurrentDeltaPath, NextDeltaPath;
+
+	for (int32 i = NumBackups - 1; i >= 0; --i)
+	{
+		if (i == 0)
+		{
+			CurrentBackupPath = SavePath;
+			CurrentDeltaPath.Reset();
+		}
+		else
+		{
+			GetBackupSaveGamePath(BasePath, i, CurrentBackupPath);
+			GetDeltaBackupSaveGamePath(BasePath, i, CurrentDeltaPath);
+		}
+
+		GetBackupSaveGamePath(BasePath, i + 1, NextBackupPath);
+		GetDeltaBackupSaveGamePath(BasePath, i + 1, NextDeltaPath);
+
+		const bool bCurrentExists = PlatformFile.FileExists(*CurrentBackupPath);
+		const bool bCurrentDeltaExists = CurrentDeltaPath.Len() > 0 && PlatformFile.FileExists(*CurrentDeltaPath);
+
+		if (!bCurrentExists && !bCurrentDeltaExists)
+		{
+			continue;
+		}
+
+		// The next backup is about to be replaced, whichever form it's in
+		if (PlatformFile.FileExists(*NextBackupPath))
+		{
+			PlatformFile.DeleteFile(*NextBackupPath);
+		}
+
+		if (PlatformFile.FileExists(*NextDeltaPath))
+		{
+			PlatformFile.DeleteFile(*NextDeltaPath);
+		}
+
+		const FDateTime FileTime = PlatformFile.GetTimeStamp(bCurrentExists ? *CurrentBackupPath : *CurrentDeltaPath);
+
+		// If we're rotating the actual save to the first backup, just to be extra safe copy the file instead of
+		// moving it. We want to minimize the amount of time where we have no save file. The save is only ever replaced
+		// by moving a new file over it, so a link to it is as good as a copy and doesn't write the whole save again.
+		if (i == 0)
+		{
+			CloneSaveFile(*NextBackupPath, *CurrentBackupPath);
+
+			// Copying the file resets the time to the current time, so to make it more clear to the user, copy the
+			// timestamp from the old file to the new one.
+			if (FileTime != FDateTime::MinValue())
+			{
+				PlatformFile.SetTimeStamp(*NextBackupPath, FileTime);
+			}
+		}
+		// The first backup is always a full file. When it moves down, it can be stored as a delta against the save,
+		// which is about to become the new first backup.
+		else if (i == 1 && bCurrentExists && UseDeltaBackups() && WriteDeltaBackup(*FString(SavePath), *CurrentBackupPath, *NextDeltaPath))
+		{
+			PlatformFile.DeleteFile(*CurrentBackupPath);
+
+			if (FileTime != FDateTime::MinValue())
+			{
+				PlatformFile.SetTimeStamp(*NextDeltaPath, FileTime);
+			}
+		}
+		else
+		{
+			if (bCurrentExists)
+			{
+				PlatformFile.MoveFile(*NextBackupPath, *CurrentBackupPath);
+			}
+
+			if (bCurrentDeltaExists)
+			{
+				PlatformFile.MoveFile(*NextDeltaPath, *CurrentDeltaPath);
+			}
+		}
+	}
+}
+
+bool FFileSaveGameSystem::ReplaceFileWithData(const FString& Path, TConstArrayView<uint8> Data) const
+{
+	FPersistenceIORequest Request;
+	Request.Type = FPersistenceIORequest::EType::Write;
+	Request.Path = Path + TEXT(".tmp");
+	Request.WriteData = Data;
+	Request.bFlush = GetFlushMode() >= 1;
+
+	if (!FPersistenceIOEngine::Get().Execute(MakeArrayView(&Request, 1)))
+	{
+		IPlatformFile::GetPlatformPhysical().DeleteFile(*Request.Path);
+		return false;
+	}
+
+	return ReplaceSaveFile(*Path, *Request.Path);
+}
+
+bool FFileSaveGameSystem::WriteDeltaBackup(const TCHAR* BasePath, const TCHAR* TargetPath, const TCHAR* DeltaPath) const
+{
+	TArray<uint8> BaseData, TargetData;
+
+	FPersistenceIORequest Requests[2];
+	Requests[0].Path = BasePath;
+	Requests[0].ReadData = &BaseData;
+	Requests[1].Path = TargetPath;
+	Requests[1].ReadData = &TargetData;
+
+	if (!FPersistenceIOEngine::Get().Execute(Requests))
+	{
+		return false;
+	}
+
+	TArray<uint8> Delta;
+	FPersistenceDelta::Create(MakeMemoryView(BaseData), MakeMemoryView(TargetData), Delta);
+
+	// If the saves don't have anything in common there's no point
+	if (Delta.Num() >= TargetData.Num())
+	{
+		return false;
+	}
+
+	return ReplaceFileWithData(DeltaPath, Delta);
+}
+
+void FFileSaveGameSystem::ExpandDeltaBackups(const FStringView BasePath) const
+{
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+	TStringBuilder<MAX_PATH> BackupPath, DeltaPath;
+
+	// Each delta is against the backup before it, so walk them from newest to oldest
+	TArray<uint8> Newer;
+	bool bHaveNewer = false;
+
+	for (int32 i = 1; i <= NumBackups; ++i)
+	{
+		GetBackupSaveGamePath(BasePath, i, BackupPath);
+		GetDeltaBackupSaveGamePath(BasePath, i, DeltaPath);
+
+		if (PlatformFile.FileExists(*BackupPath))
+		{
+			bHaveNewer = FFileHelper::LoadFileToArray(Newer, *BackupPath, FILEREAD_Silent);
+			continue;
+		}
+
+		if (!PlatformFile.FileExists(*DeltaPath))
+		{
+			bHaveNewer = false;
+			continue;
+		}
+
+		TArray<uint8> Delta, Older;
+
+		if (bHaveNewer &&
+			FFileHelper::LoadFileToArray(Delta, *DeltaPath, FILEREAD_Silent) &&
+			FPersistenceDelta::Apply(MakeMemoryView(Newer), MakeMemoryView(Delta), Older) &&
+			ReplaceFileWithData(*BackupPath, Older))
+		{
+			const FDateTime FileTime = PlatformFile.GetTimeStamp(*DeltaPath);
+			if (FileTime != FDateTime::MinValue())
+			{
+				PlatformFile.SetTimeStamp(*BackupPath, FileTime);
+			}
+
+			PlatformFile.DeleteFile(*DeltaPath);
+
+			Newer = MoveTemp(Older);
+		}
+		else
+		{
+			// Without the backup this delta was made against, it can't be rebuilt (and neither can any older ones)
+			UE_LOG(LogGunfireSaveSystem, Warning, TEXT("Couldn't rebuild delta backup '%s'"), *DeltaPath);
+
+			bHaveNewer = false;
+		}
+	}
+}
+
+FString FFileSaveGameSystem::GetSaveGamePath(const TCHAR* Name)
+{
+	TStringBuilder<MAX_PATH> TempString;
+	GetSaveGamePath(Name, TempString);
+
+	return TempString.ToString();
+}
+
+void FFileSaveGameSystem::GetSaveGamePath(const TCHAR* Name, TStringBuilderBase<TCHAR>& OutPath) const
+{
+	OutPath = SavedGamesDir;
+	OutPath.AppendChar(TEXT('/'));
+
+	if (UserFolder.Len() > 0)
+	{
+		OutPath.Append(UserFolder);
+		OutPath.AppendChar(TEXT('/'));
+	}
+
+	OutPath.Append(Name);
+	OutPath.Append(TEXT(".sav"));
+}
+
+void FFileSaveGameSystem::GetBackupSaveGamePath(const FStringView BasePath, int32 Revision, TStringBuilderBase<TCHAR>& OutPath) const
+{
+	if (NumBackups > 0)
+	{
+		OutPath = BasePath;
+		OutPath.Appendf(TEXT(".bak%d"), Revision);
+	}
+}
+
+void FFileSaveGameSystem::GetDeltaBackupSaveGamePath(const FStringView BasePath, int32 Revision, TStringBuilderBase<TCHAR>& OutPath) const
+{
+	if (NumBackups > 0)
+	{
+		OutPath = BasePath;
+		OutPath.Appendf(TEXT(".bak%d.delta"), Revision);
+	}
+}
+
+#endif // USE_FILE_SAVEGAMESYSTEM
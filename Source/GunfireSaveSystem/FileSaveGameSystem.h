@@ -0,0 +1,133 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "SaveGameSystem.h"
+#include "Misc/EngineVersionComparison.h"
+
+#if ((PLATFORM_WINDOWS && !PLATFORM_WINGDK) || PLATFORM_LINUX) && UE_VERSION_NEWER_THAN(5, 3, 0)
+#define USE_FILE_SAVEGAMESYSTEM 1
+#else
+#define USE_FILE_SAVEGAMESYSTEM 0
+#endif
+
+#if USE_FILE_SAVEGAMESYSTEM
+
+class FPersistenceSaveData;
+
+//
+// A save game system that stores saves as files, for platforms that don't have a platform specific save system. Saves
+// are written to a temp file and then moved over the old save, so a crash or power outage while saving can't leave a
+// partially written save behind. It can also keep a number of backups of each save, which are restored automatically
+// if the save is corrupt.
+//
+// This is used directly on Linux (dedicated servers and test agents), and FWindowsSaveGameSystem builds on it. It
+// requires the following lines in the platform's Engine.ini (ie, LinuxEngine.ini):
+//
+//  [PlatformFeatures]
+//  SaveGameSystemModule = GunfireSaveSystem
+//
+// SaveSystem.FlushSaves controls how hard we try to make sure a save is on disk before it replaces the old one. Files
+// are read and written through FPersistenceIOEngine, which keeps them all in flight at once on Linux.
+//
+// Since saves are only ever replaced and never written in place, the first backup is a hard link to (or a clone of) the
+// save instead of a copy. With SaveSystem.DeltaBackups, older backups are stored as deltas against the next newer one.
+//
+class GUNFIRESAVESYSTEM_API FFileSaveGameSystem : public FGenericSaveGameSystem
+{
+public:
+	FFileSaveGameSystem();
+	virtual ~FFileSaveGameSystem() {}
+
+	// Sets a suffix for the savegame path. This is intended to be used to differentiate between different users/game
+	// stores, so it could be something like "Steam_<userid>".
+	void SetUserFolder(const FStringView& UserFolderIn);
+
+	// Sets a number of backups to keep per unique save name, and the interval in seconds to create new backups.
+	void SetBackupSettings(int32 NumBackupsIn, double BackupIntervalSecondsIn);
+
+	// Returns true if a backup of the specified save type exists.
+	bool DoesBackupExist(const TCHAR* Name) const;
+
+	// Returns true if the first available backup was restored. This will overwrite the current save and will rotate all
+	// existing backups up the chain.
+	bool RestoreBackup(const TCHAR* Name) const;
+
+	// Overload to allow us to indicate whether we restored a save from a backup.
+	ESaveExistsResult DoesSaveGameExistWithResult(const TCHAR* Name, const int32 UserIndex, bool& bRestoredFromBackup);
+
+	struct FSaveRequest
+	{
+		const TCHAR* Name;
+		const TArray<uint8>* Data;
+	};
+
+	// Writes several saves at once. The new saves are all written to temp files together, and only replace the old
+	// saves once every one of them has been written, so a failed write leaves all the old saves in place.
+	bool SaveGames(TConstArrayView<FSaveRequest> Saves, const int32 UserIndex);
+
+	// Replaces one save with a copy of another, rotating its backups the same as saving it would. The copy is a link or
+	// clone when possible (see CloneSaveFile), so this doesn't write the save again.
+	bool CopySaveGame(const TCHAR* SrcName, const TCHAR* DestName);
+
+	// Maps a save file for reading instead of reading it into memory. Returns null if the save doesn't exist or can't
+	// be mapped, in which case LoadGame should be used instead. Saves are always replaced by moving a new file over
+	// them, never by writing to them in place, so the mapping stays valid after the save is replaced.
+	TSharedPtr<FPersistenceSaveData> MapSaveGame(const TCHAR* Name);
+
+	// ISaveGameSystem Begin
+	virtual ESaveExistsResult DoesSaveGameExistWithResult(const TCHAR* Name, const int32 UserIndex) override;
+	virtual bool SaveGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, const TArray<uint8>& Data) override;
+	virtual bool LoadGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, TArray<uint8>& Data) override;
+	virtual FString GetSaveGamePath(const TCHAR* Name) override;
+	// ISaveGameSystem End
+
+	// The file save game system for this platform
+	static FFileSaveGameSystem& Get();
+
+protected:
+	// Makes DestPath a copy of SrcPath, as cheaply as the platform and file system allow. The base version tries a
+	// reflink clone and then a hard link on platforms that have them (if SaveSystem.LinkBackups is on), and falls back to
+	// copying the file.
+	virtual bool CloneSaveFile(const TCHAR* DestPath, const TCHAR* SrcPath) const;
+
+	// Moves SrcPath over DestPath, replacing it. The base version relies on the platform's move replacing the
+	// destination atomically (which it does on POSIX), and falls back to deleting the destination first if it doesn't.
+	virtual bool ReplaceSaveFile(const TCHAR* DestPath, const TCHAR* SrcPath) const;
+
+	// Whether save files can be mapped while they might be replaced
+	virtual bool CanMapSaves() const { return true; }
+
+	// The current SaveSystem.FlushSaves setting
+	static int32 GetFlushMode();
+
+	static bool UseLinkedBackups();
+	static bool UseDeltaBackups();
+
+	// Writes the data to a temp file and moves it over Path
+	bool ReplaceFileWithData(const FString& Path, TConstArrayView<uint8> Data) const;
+
+	// Writes a delta that rebuilds TargetPath from BasePath. Returns false if either couldn't be read, or the delta
+	// wouldn't be any smaller than the target.
+	bool WriteDeltaBackup(const TCHAR* BasePath, const TCHAR* TargetPath, const TCHAR* DeltaPath) const;
+
+	// Rebuilds any delta backups into full backups, so they can be restored like any other backup
+	void ExpandDeltaBackups(const FStringView BasePath) const;
+
+	// Flushes a directory's entries to storage, so a file that was just moved into it will survive a power outage
+	static void FlushDirectory(const FStringView& Path);
+
+	void RotateBackups(const TCHAR* Name, const FStringView BasePath, const FStringView SavePath);
+	void GetSaveGamePath(const TCHAR* Name, TStringBuilderBase<TCHAR>& OutPath) const;
+	void GetBackupSaveGamePath(const FStringView BasePath, int32 Revision, TStringBuilderBase<TCHAR>& OutPath) const;
+	void GetDeltaBackupSaveGamePath(const FStringView BasePath, int32 Revision, TStringBuilderBase<TCHAR>& OutPath) const;
+
+	FString SavedGamesDir;
+	FString UserFolder;
+
+	int32 NumBackups = 0;
+	double BackupIntervalSeconds = 60.0 * 10.0;
+	TMap<FString, double> LastBackupTime;
+};
+
+#endif // USE_FILE_SAVEGAMESYSTEM
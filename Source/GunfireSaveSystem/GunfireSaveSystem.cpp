@@ -45,10 +45,10 @@ void FGunfireSaveSystemModule::ShutdownModule()
 
 ISaveGameSystem* FGunfireSaveSystemModule::GetSaveGameSystem()
 {
-#if USE_WINDOWS_SAVEGAMESYSTEM
-	return &FWindowsSaveGameSystem::Get();
+#if USE_FILE_SAVEGAMESYSTEM
+	return &FFileSaveGameSystem::Get();
 #else
-	// If we're not using the Windows save system this shouldn't end up getting called.
+	// If we're not using the file save system this shouldn't end up getting called.
 	checkNoEntry();
 	return nullptr;
 #endif
@@ -0,0 +1,9 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "GunfireSaveSystemVersion.h"
+
+#include "Serialization/CustomVersion.h"
+
+const FGuid FGunfireSaveSystemVersion::GUID(0x6A3D1F42, 0x8C5B4E17, 0x9F2A63D0, 0xB4E8C951);
+
+FCustomVersionRegistration GRegisterGunfireSaveSystemVersion(FGunfireSaveSystemVersion::GUID, FGunfireSaveSystemVersion::LatestVersion, TEXT("GunfireSaveSystemVer"));
@@ -0,0 +1,31 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//
+// Custom version for changes to how the save game objects serialize themselves. This is separate from
+// GUNFIRE_PERSISTENCE_VERSION (the top level save format) and the container version (the format of the container
+// blobs).
+//
+struct FGunfireSaveSystemVersion
+{
+	enum Type
+	{
+		// Before any version changes were made
+		BeforeCustomVersionWasAdded = 0,
+
+		// Persistence containers are serialized directly by the world save instead of being UObjects
+		NonObjectContainers,
+
+		// -----<new versions can be added above this line>-------------------------------------------------
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	GUNFIRESAVESYSTEM_API const static FGuid GUID;
+
+private:
+	FGunfireSaveSystemVersion() {}
+};
@@ -0,0 +1,71 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "MemorySaveGameSystem.h"
+
+#include "PersistenceManager.h"
+
+FMemorySaveGameSystem& FMemorySaveGameSystem::Get()
+{
+	static FMemorySaveGameSystem System;
+	return System;
+}
+
+void FMemorySaveGameSystem::Reset()
+{
+	FScopeLock Lock(&SavesLock);
+	Saves.Empty();
+}
+
+SIZE_T FMemorySaveGameSystem::GetAllocatedSize() const
+{
+	FScopeLock Lock(&SavesLock);
+
+	SIZE_T Size = Saves.GetAllocatedSize();
+
+	for (const TPair<FString, TArray<uint8>>& Save : Saves)
+	{
+		Size += Save.Key.GetAllocatedSize() + Save.Value.GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+FString FMemorySaveGameSystem::GetSaveKey(const TCHAR* Name, int32 UserIndex)
+{
+	return FString::Printf(TEXT("%d/%s"), UserIndex, Name);
+}
+
+ISaveGameSystem::ESaveExistsResult FMemorySaveGameSystem::DoesSaveGameExistWithResult(const TCHAR* Name, const int32 UserIndex)
+{
+	FScopeLock Lock(&SavesLock);
+	return Saves.Contains(GetSaveKey(Name, UserIndex)) ? ESaveExistsResult::OK : ESaveExistsResult::DoesNotExist;
+}
+
+bool FMemorySaveGameSystem::SaveGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, const TArray<uint8>& Data)
+{
+	LLM_SCOPE_BYTAG(Persistence);
+
+	FScopeLock Lock(&SavesLock);
+	Saves.Add(GetSaveKey(Name, UserIndex), Data);
+
+	return true;
+}
+
+bool FMemorySaveGameSystem::LoadGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, TArray<uint8>& Data)
+{
+	FScopeLock Lock(&SavesLock);
+
+	if (const TArray<uint8>* Save = Saves.Find(GetSaveKey(Name, UserIndex)))
+	{
+		Data = *Save;
+		return true;
+	}
+
+	return false;
+}
+
+bool FMemorySaveGameSystem::DeleteGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex)
+{
+	FScopeLock Lock(&SavesLock);
+	return Saves.Remove(GetSaveKey(Name, UserIndex)) > 0;
+}
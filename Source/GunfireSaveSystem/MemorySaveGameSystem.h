@@ -0,0 +1,38 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "SaveGameSystem.h"
+
+//
+// A save game system that keeps all saves in memory, so nothing is ever written to disk. This is for benchmarks and
+// tests that shouldn't be affected by (or leave behind) real save files, and for timing the save system without any
+// storage noise. Saves are lost when the process exits.
+//
+// Select it with SaveSystem.Backend Memory (not available in shipping builds).
+//
+class GUNFIRESAVESYSTEM_API FMemorySaveGameSystem : public FGenericSaveGameSystem
+{
+public:
+	// Deletes all saves
+	void Reset();
+
+	// Total size of all the saves currently held
+	SIZE_T GetAllocatedSize() const;
+
+	// ISaveGameSystem Begin
+	virtual ESaveExistsResult DoesSaveGameExistWithResult(const TCHAR* Name, const int32 UserIndex) override;
+	virtual bool SaveGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, const TArray<uint8>& Data) override;
+	virtual bool LoadGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, TArray<uint8>& Data) override;
+	virtual bool DeleteGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex) override;
+	// ISaveGameSystem End
+
+	static FMemorySaveGameSystem& Get();
+
+protected:
+	static FString GetSaveKey(const TCHAR* Name, int32 UserIndex);
+
+	// Saves are written from the persistence thread, but can be queried from the game thread
+	mutable FCriticalSection SavesLock;
+	TMap<FString, TArray<uint8>> Saves;
+};
@@ -0,0 +1,114 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceCommitProfiler.h"
+
+#include "PersistenceUtils.h"
+
+TAutoConsoleVariable<float> CVarPersistenceCommitHitchMs(TEXT("SaveSystem.CommitHitchMs"), 50.f, TEXT("Commits that take longer than this many milliseconds on the game thread log a breakdown of where the time went (0 to disable)"));
+TAutoConsoleVariable<bool> CVarPersistenceProfileCommitClasses(TEXT("SaveSystem.ProfileCommitClasses"), false, TEXT("Gathers the time and bytes spent writing each class during a commit, for the hitch report"));
+
+// The number of classes to include in the hitch report
+static const int32 MaxReportedClasses = 10;
+
+FPersistenceCommitProfiler* FPersistenceCommitProfiler::Active = nullptr;
+
+FPersistenceCommitProfiler::FPersistenceCommitProfiler()
+	: StartTime(FPlatformTime::Seconds())
+{
+	check(IsInGameThread());
+
+	// Class profiling is only useful if there's a threshold to report against
+	bProfileClasses = CVarPersistenceProfileCommitClasses.GetValueOnGameThread() && CVarPersistenceCommitHitchMs.GetValueOnGameThread() > 0.f;
+
+	if (bProfileClasses && Active == nullptr)
+	{
+		Active = this;
+	}
+}
+
+FPersistenceCommitProfiler::~FPersistenceCommitProfiler()
+{
+	if (Active == this)
+	{
+		Active = nullptr;
+	}
+}
+
+FPersistenceCommitProfiler* FPersistenceCommitProfiler::GetActive()
+{
+	// Everything we profile is written on the game thread, so ignore anything coming from other threads
+	return IsInGameThread() ? Active : nullptr;
+}
+
+void FPersistenceCommitProfiler::AddPhase(const TCHAR* Phase, double Seconds)
+{
+	Phases.Emplace(Phase, Seconds);
+}
+
+void FPersistenceCommitProfiler::AddActor(const UClass* Class, double Seconds, int64 Bytes)
+{
+	FClassStats& Stats = ActorClasses.FindOrAdd(Class);
+	Stats.Seconds += Seconds;
+	Stats.Bytes += Bytes;
+	Stats.Count++;
+}
+
+void FPersistenceCommitProfiler::AddObject(const UClass* Class, double Seconds, int64 Bytes)
+{
+	FClassStats& Stats = ObjectClasses.FindOrAdd(Class);
+	Stats.Seconds += Seconds;
+	Stats.Bytes += Bytes;
+	Stats.Count++;
+}
+
+double FPersistenceCommitProfiler::Finish(const FString& Reason)
+{
+	const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	const float ThresholdMs = CVarPersistenceCommitHitchMs.GetValueOnGameThread();
+
+	if (ThresholdMs <= 0.f || ElapsedMs <= ThresholdMs)
+	{
+		return ElapsedMs;
+	}
+
+	UE_LOG(LogGunfireSaveSystem, Warning, TEXT("Commit save '%s' took %.2f ms, over the %.2f ms hitch threshold"), *Reason, ElapsedMs, ThresholdMs);
+
+	for (const TPair<const TCHAR*, double>& Phase : Phases)
+	{
+		UE_LOG(LogGunfireSaveSystem, Warning, TEXT("  %8.2f ms  %s"), Phase.Value * 1000.0, Phase.Key);
+	}
+
+	if (bProfileClasses)
+	{
+		LogClasses(TEXT("Slowest actor classes (including components and subobjects)"), ActorClasses);
+		LogClasses(TEXT("Slowest object classes (own properties only)"), ObjectClasses);
+	}
+	else
+	{
+		UE_LOG(LogGunfireSaveSystem, Warning, TEXT("  Enable SaveSystem.ProfileCommitClasses for a per-class breakdown"));
+	}
+
+	return ElapsedMs;
+}
+
+void FPersistenceCommitProfiler::LogClasses(const TCHAR* Label, const TMap<const UClass*, FClassStats>& Classes) const
+{
+	TArray<TPair<const UClass*, FClassStats>> Sorted = Classes.Array();
+	Sorted.Sort([](const TPair<const UClass*, FClassStats>& A, const TPair<const UClass*, FClassStats>& B)
+	{
+		return A.Value.Seconds > B.Value.Seconds;
+	});
+
+	UE_LOG(LogGunfireSaveSystem, Warning, TEXT("  %s:"), Label);
+
+	const int32 NumToLog = FMath::Min(Sorted.Num(), MaxReportedClasses);
+
+	for (int32 i = 0; i < NumToLog; i++)
+	{
+		const UClass* Class = Sorted[i].Key;
+		const FClassStats& Stats = Sorted[i].Value;
+
+		UE_LOG(LogGunfireSaveSystem, Warning, TEXT("    %8.2f ms  %8lld bytes  %5d written  %s"),
+			Stats.Seconds * 1000.0, Stats.Bytes, Stats.Count, Class ? *Class->GetPathName() : TEXT("<null>"));
+	}
+}
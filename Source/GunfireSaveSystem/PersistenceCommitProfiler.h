@@ -0,0 +1,76 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//
+// Tracks where the time goes during a commit, so a slow commit can be attributed to the phase or class responsible. If
+// a commit takes longer than SaveSystem.CommitHitchMs the results are logged.
+//
+// Phase timings are always gathered since they're cheap. Per-class timings are taken for every object written, so
+// they're only gathered when SaveSystem.ProfileCommitClasses is enabled.
+//
+class FPersistenceCommitProfiler
+{
+public:
+	FPersistenceCommitProfiler();
+	~FPersistenceCommitProfiler();
+
+	FPersistenceCommitProfiler(const FPersistenceCommitProfiler&) = delete;
+	FPersistenceCommitProfiler& operator=(const FPersistenceCommitProfiler&) = delete;
+
+	// Returns the profiler gathering per-class timings for the commit in progress, or null if there isn't one
+	static FPersistenceCommitProfiler* GetActive();
+
+	void AddPhase(const TCHAR* Phase, double Seconds);
+
+	// Actor timings include everything written for the actor (transform, components and subobjects), while object
+	// timings are just for the properties of that object.
+	void AddActor(const UClass* Class, double Seconds, int64 Bytes);
+	void AddObject(const UClass* Class, double Seconds, int64 Bytes);
+
+	// Logs the results if the commit went over the hitch threshold, and returns how long the commit took in ms
+	double Finish(const FString& Reason);
+
+private:
+	struct FClassStats
+	{
+		double Seconds = 0.0;
+		int64 Bytes = 0;
+		int32 Count = 0;
+	};
+
+	void LogClasses(const TCHAR* Label, const TMap<const UClass*, FClassStats>& Classes) const;
+
+	double StartTime = 0.0;
+
+	TArray<TPair<const TCHAR*, double>> Phases;
+	TMap<const UClass*, FClassStats> ActorClasses;
+	TMap<const UClass*, FClassStats> ObjectClasses;
+
+	bool bProfileClasses = false;
+
+	static FPersistenceCommitProfiler* Active;
+};
+
+// Adds the time spent in a scope to a phase of a commit profile
+struct FPersistenceCommitPhaseScope
+{
+	FPersistenceCommitPhaseScope(FPersistenceCommitProfiler& InProfiler, const TCHAR* InPhase)
+		: Profiler(InProfiler)
+		, Phase(InPhase)
+		, StartTime(FPlatformTime::Seconds())
+	{
+	}
+
+	~FPersistenceCommitPhaseScope()
+	{
+		Profiler.AddPhase(Phase, FPlatformTime::Seconds() - StartTime);
+	}
+
+private:
+	FPersistenceCommitProfiler& Profiler;
+	const TCHAR* Phase;
+	double StartTime;
+};
@@ -52,7 +52,7 @@ void UPersistenceComponent::InitializeComponent()
 			}
 		}
 
-		UPersistenceContainer* Container = nullptr;
+		FPersistenceContainer* Container = nullptr;
 
 		UPersistenceManager* Manager = UPersistenceManager::GetInstance(this);
 		if (Manager != nullptr)
@@ -16,7 +16,7 @@
 UCLASS(meta = (BlueprintSpawnableComponent))
 class GUNFIRESAVESYSTEM_API UPersistenceComponent : public UActorComponent
 {
-	friend class UPersistenceContainer;
+	friend class FPersistenceContainer;
 	friend class UPersistenceManager;
 
 	GENERATED_BODY()
@@ -27,6 +27,9 @@ public:
 	// Determines if the persistent id is valid or not
 	bool HasValidPersistentId() const { return UniqueId.IsValid() || !SaveKey.IsNone(); }
 
+	const FGuid& GetUniqueId() const { return UniqueId; }
+	const FName& GetSaveKey() const { return SaveKey; }
+
 	// Return true if we should persist
 	bool ShouldPersist() const;
 
@@ -82,12 +85,21 @@ protected:
 
 	bool bHasBeenDestroyed = false;
 
+	// The slot this component occupies in the persistence manager's registered list for its container, so it can be
+	// unregistered without searching the list. INDEX_NONE if it isn't registered.
+	int32 RegisteredIndex = INDEX_NONE;
+
 	// Public so they can be set in constructors, but these shouldn't be changed at runtime otherwise.
 public:
 	// Set to true if you want to persist the transform of this actor.
 	UPROPERTY(EditDefaultsOnly, Category = Persistence)
 	bool PersistTransform = false;
 
+	// If set, the persisted transform is stored with centimeter precision and a compressed rotation, which is much
+	// smaller than the full transform. This can also be enabled for all actors in the save system settings.
+	UPROPERTY(EditDefaultsOnly, Category = Persistence, meta = (EditCondition = "PersistTransform"))
+	bool CompactTransform = false;
+
 	// If true, this object will persist when it's destroyed, and on a subsequent load of the map the object will be
 	// removed.
 	UPROPERTY(EditDefaultsOnly, Category = Persistence)
@@ -99,4 +111,11 @@ public:
 
 	// Returns if this actor has been latently destroyed due to persistence
 	bool HasBeenDestroyed() const { return bHasBeenDestroyed; }
+
+#if !UE_BUILD_SHIPPING
+	// For tools that register components outside of the normal actor lifecycle, like the benchmark commandlet. Game
+	// code shouldn't need these.
+	void SetDynamicForTesting(bool bDynamic) { IsDynamic = bDynamic; }
+	void SetUniqueIdForTesting(const FGuid& InUniqueId) { UniqueId = InUniqueId; }
+#endif
 };
@@ -2,12 +2,18 @@
 
 #include "PersistenceContainer.h"
 
+#include "PersistenceCommitProfiler.h"
 #include "PersistenceComponent.h"
+#include "PersistenceLevelManifest.h"
 #include "PersistenceManager.h"
+#include "PersistenceSaveData.h"
+#include "PersistenceSizeReport.h"
+#include "PersistenceTrace.h"
 #include "PersistenceUtils.h"
 
 #include "Engine/AssetManager.h"
 #include "Engine/World.h"
+#include "Hash/CityHash.h"
 #include "Kismet/GameplayStatics.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
@@ -17,13 +23,30 @@
 
 DECLARE_CYCLE_STAT(TEXT("Container WriteData"), STAT_PersistenceGunfire_ContainerWriteData, STATGROUP_Persistence);
 DECLARE_CYCLE_STAT(TEXT("Container Unpack"), STAT_PersistenceGunfire_ContainerUnpack, STATGROUP_Persistence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Actor Records Written"), STAT_PersistenceGunfire_RecordsWritten, STATGROUP_Persistence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Deduplicated Actor Records"), STAT_PersistenceGunfire_RecordsDeduplicated, STATGROUP_Persistence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Deduplicated Actor Bytes"), STAT_PersistenceGunfire_BytesDeduplicated, STATGROUP_Persistence);
+
+TRACE_DECLARE_INT_COUNTER(PersistenceContainerBytesWritten, TEXT("Persistence/Container Bytes Written"));
+TRACE_DECLARE_INT_COUNTER(PersistenceActorsWritten, TEXT("Persistence/Actors Written"));
 
 // This version is for backwards compatible changes. Non backwards compatible changes should just bump
 // GUNFIRE_PERSISTENCE_VERSION and invalidate all old savegames.
 //
 // Version History
 // 1: Reset due to GUNFIRE_PERSISTENCE_VERSION bump
-#define CONTAINER_VERSION 1
+// 2: Added header flags and the compact id encoding
+// 3: Transforms are written with an encoding mode
+// 4: The save game archive version is stored once in the header instead of in every actor record
+#define CONTAINER_VERSION 4
+
+// Actor ids are written once to a table in the index. Actor info is stored as packed ints, the destroyed list is implied
+// by the end of the table, and dynamic actors refer to their info by packed index instead of repeating the guid.
+#define CONTAINER_FLAG_COMPACT_IDS (1 << 0)
+
+// Destroyed actors that are in the level's persistent actor manifest are written as a bit per manifest entry, and only
+// the remaining ones are written out by id.
+#define CONTAINER_FLAG_MANIFEST_DESTROYED (1 << 1)
 
 struct FSubArchive : public FArchiveProxy
 {
@@ -33,6 +56,31 @@ struct FSubArchive : public FArchiveProxy
 		Offset = InnerArchive.Tell();
 	}
 
+	// Makes the current position of the inner archive the start of this one
+	void Rebase()
+	{
+		Offset = InnerArchive.Tell();
+	}
+
+	// Stops reads at Length bytes past the start, flagging an error instead of reading past it. A negative length
+	// removes the limit.
+	void SetLimit(int64 Length)
+	{
+		Limit = Length;
+	}
+
+	virtual void Serialize(void* Data, int64 Num) override
+	{
+		if (Limit >= 0 && IsLoading() && Tell() + Num > Limit)
+		{
+			FMemory::Memzero(Data, Num);
+			SetError();
+			return;
+		}
+
+		InnerArchive.Serialize(Data, Num);
+	}
+
 	virtual int64 Tell() override
 	{
 		return InnerArchive.Tell() - Offset;
@@ -40,7 +88,7 @@ struct FSubArchive : public FArchiveProxy
 
 	virtual int64 TotalSize() override
 	{
-		return InnerArchive.TotalSize() - Offset;
+		return Limit >= 0 ? Limit : InnerArchive.TotalSize() - Offset;
 	}
 
 	virtual void Seek(int64 InPos) override
@@ -49,69 +97,195 @@ struct FSubArchive : public FArchiveProxy
 	}
 
 	int64 Offset;
+	int64 Limit = -1;
+};
+
+struct FPersistenceContainer::FReadContext
+{
+	FReadContext(FMemoryView Data, const FHeader& Header)
+		: Reader(Data, true)
+		, SubAr(InitReader(Reader, Header))
+		, PAr(SubAr, const_cast<FNameCache&>(Header.NameCache), Header.ArchiveVersion)
+	{
+	}
+
+	// The proxy archives copy the versions from the reader when they're created, so it needs to be set up first
+	static FArchive& InitReader(FArchive& Ar, const FHeader& Header)
+	{
+		Header.InitArchive(Ar);
+		return Ar;
+	}
+
+	FMemoryReaderView Reader;
+	FSubArchive SubAr;
+	FSaveGameArchive PAr;
+
+	// Set while an actor is being read, in case reading one actor somehow triggers a load for another
+	bool bInUse = false;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void UPersistenceContainer::FHeader::Reset()
+void FPersistenceContainer::FHeader::Reset()
 {
 	Version = CONTAINER_VERSION;
 	UEVersion = GPackageFileUEVersion;
 	IndexOffset = 0;
 	DynamicOffset = 0;
+	Flags = 0;
+	ArchiveVersion = FSaveGameArchive::GetLatestVersion();
+	ManifestDestroyedSize = 0;
 
 	Info.Reset();
 	Destroyed.Reset();
 	CustomVersions.Empty();
 	NameCache.Reset();
+	IdLookup.Reset();
 }
 
-void UPersistenceContainer::FHeader::Serialize(FArchive& Ar)
+void FPersistenceContainer::FHeader::Serialize(FArchive& Ar, const UPersistenceLevelManifest* Manifest, bool bDescribing)
 {
 	Ar << Version;
 	Ar << UEVersion;
 	Ar << DynamicOffset;
 	Ar << IndexOffset;
 
+	if (Version >= 2)
+	{
+		Ar << Flags;
+	}
+
+	if (Version >= 4)
+	{
+		Ar << ArchiveVersion;
+	}
+
 	if (Ar.IsLoading())
 	{
 		const int64 DataStartOffset = Ar.Tell();
 
 		Ar.Seek(IndexOffset);
 
-		SerializeVariable(Ar);
+		SerializeVariable(Ar, Manifest, bDescribing);
 
 		Ar.Seek(DataStartOffset);
 	}
 }
 
-void UPersistenceContainer::FHeader::SerializeVariable(FArchive& Ar)
+void FPersistenceContainer::FHeader::SerializeVariable(FArchive& Ar, const UPersistenceLevelManifest* Manifest, bool bDescribing)
 {
 	if (Ar.IsSaving())
 	{
 		IndexOffset = Ar.Tell();
 	}
 
-	// Serialize the index for actors we wrote
-	uint32 NumInfos = Info.Num();
-	Ar << NumInfos;
-	Info.SetNum(NumInfos);
+	// Pull out any destroyed actors that are in the manifest, so only the remainder are written by id below. They're
+	// added back once we're done.
+	TArray<FGuid> ManifestDestroyed;
 
-	for (FInfo& CurInfo : Info)
+	if (HasManifestDestroyed())
 	{
-		Ar << CurInfo.UniqueId;
-		Ar << CurInfo.Offset;
-		Ar << CurInfo.Length;
+		const int64 ManifestDestroyedStart = Ar.Tell();
+
+		FGuid ManifestId;
+		TBitArray<> DestroyedBits;
+
+		if (Ar.IsSaving() && ensure(Manifest))
+		{
+			ManifestId = Manifest->GetManifestId();
+			DestroyedBits.Init(false, Manifest->NumActors());
+
+			for (int32 i = Destroyed.Num() - 1; i >= 0; i--)
+			{
+				const int32 ManifestIndex = Manifest->FindActorIndex(Destroyed[i]);
+
+				if (ManifestIndex != INDEX_NONE)
+				{
+					DestroyedBits[ManifestIndex] = true;
+					ManifestDestroyed.Add(Destroyed[i]);
+					Destroyed.RemoveAtSwap(i, 1, false);
+				}
+			}
+		}
+
+		Ar << ManifestId;
+		Ar << DestroyedBits;
+
+		// A size report can't restore anything, so there's nothing to warn about
+		if (Ar.IsLoading() && bDescribing)
+		{
+			ManifestDestroyedSize = Ar.Tell() - ManifestDestroyedStart;
+		}
+		else if (Ar.IsLoading())
+		{
+			if (Manifest != nullptr && Manifest->GetManifestId() == ManifestId)
+			{
+				for (TConstSetBitIterator<> It(DestroyedBits); It; ++It)
+				{
+					if (It.GetIndex() < Manifest->NumActors())
+					{
+						ManifestDestroyed.Add(Manifest->GetActorId(It.GetIndex()));
+					}
+				}
+			}
+			else
+			{
+				UE_LOG(LogGunfireSaveSystem, Warning, TEXT("Container was saved against a level manifest that isn't loaded, %d destroyed actors will be restored"),
+					DestroyedBits.CountSetBits());
+			}
+		}
 	}
 
-	// Serialize the destroyed actor ids
-	uint32 NumDestroyed = Destroyed.Num();
-	Ar << NumDestroyed;
-	Destroyed.SetNum(NumDestroyed);
+	if (HasCompactIds())
+	{
+		// Serialize the id table, which is the ids for the actors we wrote followed by the destroyed actor ids
+		uint32 NumInfos = Info.Num();
+		uint32 NumDestroyed = Destroyed.Num();
+		Ar.SerializeIntPacked(NumInfos);
+		Ar.SerializeIntPacked(NumDestroyed);
+		Info.SetNum(NumInfos);
+		Destroyed.SetNum(NumDestroyed);
+
+		for (FInfo& CurInfo : Info)
+		{
+			Ar << CurInfo.UniqueId;
+		}
+
+		for (FGuid& DestroyedId : Destroyed)
+		{
+			Ar << DestroyedId;
+		}
 
-	for (FGuid& DestroyedId : Destroyed)
+		// Serialize the index for actors we wrote, in the same order as the id table
+		for (FInfo& CurInfo : Info)
+		{
+			Ar.SerializeIntPacked(CurInfo.Offset);
+			Ar.SerializeIntPacked(CurInfo.Length);
+		}
+	}
+	else
 	{
-		Ar << DestroyedId;
+		// Serialize the index for actors we wrote
+		uint32 NumInfos = Info.Num();
+		Ar << NumInfos;
+		Info.SetNum(NumInfos);
+
+		for (FInfo& CurInfo : Info)
+		{
+			Ar << CurInfo.UniqueId;
+			Ar << CurInfo.Offset;
+			Ar << CurInfo.Length;
+		}
+
+		// Serialize the destroyed actor ids
+		uint32 NumDestroyed = Destroyed.Num();
+		Ar << NumDestroyed;
+		Destroyed.SetNum(NumDestroyed);
+
+		for (FGuid& DestroyedId : Destroyed)
+		{
+			Ar << DestroyedId;
+		}
 	}
 
 	// Serialize the custom versions for any objects we wrote
@@ -123,81 +297,284 @@ void UPersistenceContainer::FHeader::SerializeVariable(FArchive& Ar)
 
 	// Serialize the cache of unique FNames for all objects in this container
 	NameCache.Serialize(Ar);
+
+	Destroyed.Append(ManifestDestroyed);
+
+	BuildIdLookup();
 }
 
-void UPersistenceContainer::FHeader::InitArchive(FArchive& Ar) const
+void FPersistenceContainer::FHeader::InitArchive(FArchive& Ar) const
 {
 	Ar.SetUEVer(UEVersion);
 	Ar.SetCustomVersions(CustomVersions);
 }
 
+void FPersistenceContainer::FHeader::BuildIdLookup()
+{
+	IdLookup.Reset();
+	IdLookup.Reserve(Info.Num() + Destroyed.Num());
+
+	for (int32 i = 0; i < Info.Num(); i++)
+	{
+		IdLookup.Add(Info[i].UniqueId, i);
+	}
+
+	// An actor can have saved data and be destroyed afterwards, in which case the saved data takes precedence.
+	for (const FGuid& DestroyedId : Destroyed)
+	{
+		IdLookup.FindOrAdd(DestroyedId, INDEX_NONE);
+	}
+}
+
+bool FPersistenceContainer::FHeader::HasCompactIds() const
+{
+	return (Flags & CONTAINER_FLAG_COMPACT_IDS) != 0;
+}
+
+bool FPersistenceContainer::FHeader::HasManifestDestroyed() const
+{
+	return (Flags & CONTAINER_FLAG_MANIFEST_DESTROYED) != 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void UPersistenceContainer::Pack()
+FPersistenceContainer::FPersistenceContainer()
+{
+}
+
+FPersistenceContainer::FPersistenceContainer(const FName& InKey, TArray<uint8>&& InData)
+	: Key(InKey)
+{
+	Blob.Data = MoveTemp(InData);
+}
+
+FPersistenceContainer::~FPersistenceContainer()
 {
+}
+
+void FPersistenceContainer::Serialize(FArchive& Ar, const TSharedPtr<const FPersistenceSaveData>& SaveData)
+{
+	Ar << Key;
+
+	// The data is laid out the same as a serialized array either way, so saves don't care which path wrote them
+	if (Ar.IsLoading() && SaveData.IsValid())
+	{
+		int32 NumBytes = 0;
+		Ar << NumBytes;
+
+		const FMemoryView SaveView = SaveData->GetView();
+		const int64 Offset = Ar.Tell();
+
+		if (NumBytes < 0 || Offset < 0 || Offset + NumBytes > static_cast<int64>(SaveView.GetSize()))
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Blob.Data.Empty();
+		SharedSave = SaveData;
+		SharedView = SaveView.Mid(Offset, NumBytes);
+
+		Ar.Seek(Offset + NumBytes);
+	}
+	else if (Ar.IsSaving() && SharedSave.IsValid())
+	{
+		int32 NumBytes = static_cast<int32>(SharedView.GetSize());
+		Ar << NumBytes;
+		Ar.Serialize(const_cast<void*>(SharedView.GetData()), NumBytes);
+	}
+	else
+	{
+		Ar << Blob.Data;
+
+		if (Ar.IsLoading())
+		{
+			SharedSave.Reset();
+			SharedView.Reset();
+		}
+	}
+
+	if (Ar.IsLoading())
+	{
+		Pack();
+	}
+}
+
+void FPersistenceContainer::Pack()
+{
+	ReadContext.Reset();
 	Header.Reset();
 	LoadState = EClassLoadState::Uninitialized;
+	NumPendingDynamicActors = 0;
+	Manifest.Reset();
+}
+
+SIZE_T FPersistenceContainer::GetUnpackedSize() const
+{
+	SIZE_T Size =
+		Header.Info.GetAllocatedSize() +
+		Header.Destroyed.GetAllocatedSize() +
+		Header.IdLookup.GetAllocatedSize() +
+		Header.NameCache.GetAllocatedSize();
+
+	if (ReadContext.IsValid())
+	{
+		Size += sizeof(FReadContext);
+	}
+
+	return Size;
 }
 
-void UPersistenceContainer::Unpack()
+void FPersistenceContainer::Unpack()
 {
+	LLM_SCOPE_BYTAG(Persistence);
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence Unpack %s (%d bytes)"), *Key.ToString(), static_cast<int32>(GetData().GetSize()));
+
 	// Shouldn't be calling unpack if we're already unpacked
 	ensure(IsPacked());
 
 	Header.Reset();
 
-	if (Blob.Data.Num() > 0)
+	if (GetData().GetSize() > 0)
 	{
-		FMemoryReader Ar(Blob.Data, true);
-		Header.Serialize(Ar);
+		FMemoryReaderView Ar(GetData(), true);
+		Header.Serialize(Ar, Manifest.Get());
 	}
 }
 
-void UPersistenceContainer::WriteData(TArrayView<TWeakObjectPtr<UPersistenceComponent>> Components, UPersistenceManager& Manager)
+void FPersistenceContainer::WriteData(TArrayView<TWeakObjectPtr<UPersistenceComponent>> Components, UPersistenceManager& Manager)
 {
+	LLM_SCOPE_BYTAG(Persistence);
 	SCOPE_CYCLE_COUNTER(STAT_PersistenceGunfire_ContainerWriteData);
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence WriteContainer %s (%d actors)"), *Key.ToString(), Components.Num());
 
 	UE_LOG(LogGunfireSaveSystem, VeryVerbose, TEXT("------------------------------------------------------------------------------------------"));
-	UE_LOG(LogGunfireSaveSystem, Verbose, TEXT("Writing persistence container '%s' (%s)"), *Key.ToString(), *GetName());
+	UE_LOG(LogGunfireSaveSystem, Verbose, TEXT("Writing persistence container '%s'"), *Key.ToString());
 
+	ReadContext.Reset();
 	Blob.Data.Reset();
+	SharedSave.Reset();
+	SharedView.Reset();
 
 	FMemoryWriter Ar(Blob.Data, true);
 
 	// Stub in the header for data we don't calculate until the end, we'll rewrite it later
 	Header.Reset();
-	Header.Serialize(Ar);
+
+	if (GetDefault<UGunfireSaveSystemSettings>()->CompactContainerIds)
+	{
+		Header.Flags |= CONTAINER_FLAG_COMPACT_IDS;
+	}
+
+	Header.Serialize(Ar, nullptr);
+
+	// The manager doesn't keep registered components in any particular order, so sort them by id to keep the output
+	// deterministic from one write to the next.
+	TArray<UPersistenceComponent*, TInlineAllocator<64>> SortedComponents;
+	SortedComponents.Reserve(Components.Num());
+
+	for (const TWeakObjectPtr<UPersistenceComponent>& Component : Components)
+	{
+		if (UPersistenceComponent* RawComponent = Component.Get())
+		{
+			SortedComponents.Add(RawComponent);
+		}
+	}
+
+	SortedComponents.Sort([](const UPersistenceComponent& A, const UPersistenceComponent& B) { return A.UniqueId < B.UniqueId; });
+
+	if (SortedComponents.Num() > 0)
+	{
+		UpdateManifest(SortedComponents[0]);
+	}
 
 	int32 NumDynamicActors = 0;
 
+	// Hashes of the records we've written so far, mapped to the index of the info that wrote them. Many actors (like
+	// untouched doors or unlooted chests of the same class) write byte identical records, so those can all share the
+	// first copy. Records are written through a subarchive, so they don't contain anything specific to their location.
+	TMultiMap<uint64, int32> RecordHashes;
+	RecordHashes.Reserve(SortedComponents.Num());
+
+	int32 NumDeduplicated = 0;
+	uint32 BytesDeduplicated = 0;
+
+	// When we read the component back in we'll give it an archive with just its data, so wrap the output archive in a
+	// subarchive (rebased for each actor) to ensure any offsets written are correct when read back in. The save game
+	// archive is shared by all the actors, so it only has to be set up once.
+	FSubArchive SubAr(Ar);
+	FSaveGameArchive PAr(SubAr, Header.NameCache, Header.ArchiveVersion);
+
+	FPersistenceCommitProfiler* Profiler = FPersistenceCommitProfiler::GetActive();
+
 	//
 	// Write out the per-actor save data
 	//
-	for (const TWeakObjectPtr<UPersistenceComponent>& Component : Components)
+	for (UPersistenceComponent* RawComponent : SortedComponents)
 	{
-		if (UPersistenceComponent* RawComponent = Component.Get())
+		if (RawComponent->IsDynamic)
 		{
-			if (RawComponent->IsDynamic)
-			{
-				NumDynamicActors++;
-			}
+			NumDynamicActors++;
+		}
 
-			FInfo& ThisInfo = Header.Info[Header.Info.AddUninitialized()];
-			ThisInfo.UniqueId = RawComponent->UniqueId;
-			ThisInfo.Offset = static_cast<uint32>(Ar.Tell());
+		FInfo& ThisInfo = Header.Info[Header.Info.AddUninitialized()];
+		ThisInfo.UniqueId = RawComponent->UniqueId;
+		ThisInfo.Offset = static_cast<uint32>(Ar.Tell());
 
+		const double WriteStartTime = Profiler ? FPlatformTime::Seconds() : 0.0;
+
+		SubAr.Rebase();
+		PAr.Reset();
+		WriteData(RawComponent, Manager, SubAr, PAr);
+
+		// Calculate the total size of the save data for this actor
+		ThisInfo.Length = static_cast<uint32>(Ar.Tell()) - ThisInfo.Offset;
+
+		if (Profiler)
+		{
+			Profiler->AddActor(RawComponent->GetOwner()->GetClass(), FPlatformTime::Seconds() - WriteStartTime, ThisInfo.Length);
+		}
+
+		INC_DWORD_STAT(STAT_PersistenceGunfire_RecordsWritten);
+
+		// If an identical record has already been written, point at that one and throw away the copy we just wrote.
+		const uint8* RecordData = Blob.Data.GetData() + ThisInfo.Offset;
+		const uint64 RecordHash = CityHash64(reinterpret_cast<const char*>(RecordData), ThisInfo.Length);
+
+		bool bFoundDuplicate = false;
+
+		for (auto It = RecordHashes.CreateConstKeyIterator(RecordHash); It; ++It)
+		{
+			const FInfo& OtherInfo = Header.Info[It.Value()];
+
+			if (OtherInfo.Length == ThisInfo.Length &&
+				FMemory::Memcmp(Blob.Data.GetData() + OtherInfo.Offset, RecordData, ThisInfo.Length) == 0)
 			{
-				// When we read the component back in we'll give it an archive with just its data, so wrap the output
-				// archive in a subarchive to ensure any offsets written are correct when read back in.
-				FSubArchive SubAr(Ar);
-				WriteData(RawComponent, Manager, SubAr);
+				NumDeduplicated++;
+				BytesDeduplicated += ThisInfo.Length;
+
+				Blob.Data.SetNum(ThisInfo.Offset, false);
+				Ar.Seek(ThisInfo.Offset);
+
+				ThisInfo.Offset = OtherInfo.Offset;
+
+				bFoundDuplicate = true;
+				break;
 			}
+		}
 
-			// Calculate the total size of the save data for this actor
-			ThisInfo.Length = static_cast<uint32>(Ar.Tell()) - ThisInfo.Offset;
+		if (!bFoundDuplicate)
+		{
+			RecordHashes.Add(RecordHash, Header.Info.Num() - 1);
 		}
 	}
 
+	INC_DWORD_STAT_BY(STAT_PersistenceGunfire_RecordsDeduplicated, NumDeduplicated);
+	INC_DWORD_STAT_BY(STAT_PersistenceGunfire_BytesDeduplicated, BytesDeduplicated);
+
+	UE_CLOG(NumDeduplicated > 0, LogGunfireSaveSystem, Verbose, TEXT("Deduplicated %d of %d actor records (%u bytes) in container '%s'"),
+		NumDeduplicated, SortedComponents.Num(), BytesDeduplicated, *Key.ToString());
+
 	//
 	// Write out info for spawning dynamic actors
 	//
@@ -205,40 +582,61 @@ void UPersistenceContainer::WriteData(TArrayView<TWeakObjectPtr<UPersistenceComp
 	
 	Ar << NumDynamicActors;
 
-	for (const TWeakObjectPtr<UPersistenceComponent>& Component : Components)
+	for (int32 InfoIndex = 0; InfoIndex < SortedComponents.Num(); InfoIndex++)
 	{
-		if (UPersistenceComponent* RawComponent = Component.Get())
+		UPersistenceComponent* RawComponent = SortedComponents[InfoIndex];
+		AActor* Actor = RawComponent->GetOwner();
+
+		if (RawComponent->IsDynamic)
 		{
-			AActor* Actor = RawComponent->GetOwner();
+			UE_LOG(LogGunfireSaveSystem, VeryVerbose, TEXT("Dynamic actor '%s'"), *Actor->GetName());
 
-			if (RawComponent->IsDynamic)
+			// Every component has an info entry in the same order we're iterating, so with compact ids we can just
+			// refer to that instead of writing the id again.
+			if (Header.HasCompactIds())
+			{
+				uint32 PackedIndex = static_cast<uint32>(InfoIndex);
+				Ar.SerializeIntPacked(PackedIndex);
+			}
+			else
 			{
-				UE_LOG(LogGunfireSaveSystem, VeryVerbose, TEXT("Dynamic actor '%s'"), *Actor->GetName());
-
 				Ar << RawComponent->UniqueId;
+			}
 
-				FTransform Transform = Actor->GetTransform();
+			FTransform Transform = Actor->GetTransform();
 
-				// Remove offset if there is an offset
-				Manager.RemoveLevelOffset(Actor->GetLevel(), Transform);
+			// Remove offset if there is an offset
+			Manager.RemoveLevelOffset(Actor->GetLevel(), Transform);
 
-				Ar << Transform;
+			EPersistenceTransformEncoding Encoding = UPersistenceUtils::GetTransformEncoding(Transform, UseCompactTransform(RawComponent));
+			Ar << Encoding;
+			UPersistenceUtils::SerializeTransform(Ar, Transform, Encoding);
 
-				FTopLevelAssetPath ClassPath = Actor->GetClass()->GetClassPathName();
-				Ar << ClassPath;
-			}
+			FTopLevelAssetPath ClassPath = Actor->GetClass()->GetClassPathName();
+			Ar << ClassPath;
 		}
 	}
 
+	// If this level has a manifest, use it to store destroyed actors more compactly
+	const UPersistenceLevelManifest* CurrentManifest = Manifest.Get();
+
+	if (CurrentManifest != nullptr)
+	{
+		Header.Flags |= CONTAINER_FLAG_MANIFEST_DESTROYED;
+	}
+
 	// Write out all the variable size header data at the end
-	Header.SerializeVariable(Ar);
+	Header.SerializeVariable(Ar, CurrentManifest);
 
 	// Write the final offsets
 	Ar.Seek(0);
-	Header.Serialize(Ar);
+	Header.Serialize(Ar, CurrentManifest);
+
+	TRACE_COUNTER_ADD(PersistenceContainerBytesWritten, Blob.Data.Num());
+	TRACE_COUNTER_ADD(PersistenceActorsWritten, SortedComponents.Num());
 }
 
-void UPersistenceContainer::PreloadDynamicActors(ULevel* Level, UPersistenceManager& Manager)
+void FPersistenceContainer::PreloadDynamicActors(ULevel* Level, UPersistenceManager& Manager)
 {
 	if (LoadState == EClassLoadState::Uninitialized)
 	{
@@ -246,7 +644,7 @@ void UPersistenceContainer::PreloadDynamicActors(ULevel* Level, UPersistenceMana
 	}
 }
 
-bool UPersistenceContainer::IsPreloadingDynamicActors(bool bCheckDelegates) const
+bool FPersistenceContainer::IsPreloadingDynamicActors(bool bCheckDelegates) const
 {
 	// If we requested to check delegates, check if the delegate is complete but not triggered yet, and allow the
 	// loading to continue in that case.
@@ -259,12 +657,12 @@ bool UPersistenceContainer::IsPreloadingDynamicActors(bool bCheckDelegates) cons
 	return LoadState == EClassLoadState::Preloading;
 }
 
-bool UPersistenceContainer::HasSpawnedDynamicActors() const
+bool FPersistenceContainer::HasSpawnedDynamicActors() const
 {
 	return LoadState == EClassLoadState::Complete;
 }
 
-bool UPersistenceContainer::SpawnDynamicActors(ULevel* Level, UPersistenceManager& Manager)
+bool FPersistenceContainer::SpawnDynamicActors(ULevel* Level, UPersistenceManager& Manager)
 {
 	// If we already finished the load (or everything was already loaded), spawn the dynamic actors now.
 	if (LoadState == EClassLoadState::SpawningDynamicActors)
@@ -287,9 +685,11 @@ bool UPersistenceContainer::SpawnDynamicActors(ULevel* Level, UPersistenceManage
 	return false;
 }
 
-void UPersistenceContainer::SpawnDynamicActorsInternal(ULevel* Level, UPersistenceManager& Manager, bool Spawn)
+void FPersistenceContainer::SpawnDynamicActorsInternal(ULevel* Level, UPersistenceManager& Manager, bool Spawn)
 {
-	FMemoryReader Ar(Blob.Data, true);
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence %s %s"), Spawn ? TEXT("SpawnDynamicActors") : TEXT("PreloadDynamicActors"), *Key.ToString());
+
+	FMemoryReaderView Ar(GetData(), true);
 
 	ensure(Header.IsUnpacked());
 	Header.InitArchive(Ar);
@@ -299,6 +699,8 @@ void UPersistenceContainer::SpawnDynamicActorsInternal(ULevel* Level, UPersisten
 	int32 NumDynamicActors;
 	Ar << NumDynamicActors;
 
+	NumPendingDynamicActors = Spawn ? 0 : NumDynamicActors;
+
 	TArray<FSoftObjectPath> ClassesToLoad;
 
 	UE_CLOG(NumDynamicActors > 0 && Spawn, LogGunfireSaveSystem, Log, TEXT("Spawning %d dynamic actors for container '%s'"), NumDynamicActors, *Key.ToString());
@@ -306,17 +708,13 @@ void UPersistenceContainer::SpawnDynamicActorsInternal(ULevel* Level, UPersisten
 	for (int32 i = 0; i < NumDynamicActors; i++)
 	{
 		FGuid UniqueId;
-		Ar << UniqueId;
-
 		FTransform Transform;
-		Ar << Transform;
+		FTopLevelAssetPath ClassPath;
+		ReadDynamicActor(Ar, Header, UniqueId, Transform, ClassPath);
 
 		// Add offset if there is one
 		Manager.AddLevelOffset(Level, Transform);
 
-		FTopLevelAssetPath ClassPath;
-		Ar << ClassPath;
-
 		if (!Spawn)
 		{
 			ClassesToLoad.AddUnique(FSoftObjectPath(ClassPath));
@@ -366,7 +764,7 @@ void UPersistenceContainer::SpawnDynamicActorsInternal(ULevel* Level, UPersisten
 
 			DynamicActorLoad = UAssetManager::GetStreamableManager().RequestAsyncLoad(
 				ClassesToLoad,
-				FStreamableDelegate::CreateUObject(this, &ThisClass::OnDynamicActorsLoaded, Level),
+				FStreamableDelegate::CreateSP(this, &FPersistenceContainer::OnDynamicActorsLoaded, Level),
 				FStreamableManager::AsyncLoadHighPriority);
 		}
 		else
@@ -380,7 +778,7 @@ void UPersistenceContainer::SpawnDynamicActorsInternal(ULevel* Level, UPersisten
 	}
 }
 
-void UPersistenceContainer::OnDynamicActorsLoaded(ULevel* Level)
+void FPersistenceContainer::OnDynamicActorsLoaded(ULevel* Level)
 {
 	// Still haven't tried to spawn the actors, just flag them as ready
 	if (LoadState == EClassLoadState::Preloading)
@@ -404,37 +802,82 @@ void UPersistenceContainer::OnDynamicActorsLoaded(ULevel* Level)
 	}
 }
 
-FGuid UPersistenceContainer::GetSpawningActorId()
+FGuid FPersistenceContainer::GetSpawningActorId()
 {
 	const FGuid Ret = SpawningActorId;
 	SpawningActorId.Invalidate();
 	return Ret;
 }
 
-void UPersistenceContainer::SetDestroyed(UPersistenceComponent* Component)
+void FPersistenceContainer::SetDestroyed(UPersistenceComponent* Component)
 {
-	ensureMsgf(!Header.Destroyed.Contains(Component->UniqueId), TEXT("Adding destroyed actor twice"));
+	UpdateManifest(Component);
+
+	const int32* ExistingIndex = Header.IdLookup.Find(Component->UniqueId);
+	ensureMsgf(ExistingIndex == nullptr || *ExistingIndex != INDEX_NONE, TEXT("Adding destroyed actor twice"));
 
 	Header.Destroyed.Emplace(Component->UniqueId);
+	Header.IdLookup.FindOrAdd(Component->UniqueId, INDEX_NONE);
 }
 
-void UPersistenceContainer::LoadData(UPersistenceComponent* Component, UPersistenceManager& Manager) const
+void FPersistenceContainer::LoadData(UPersistenceComponent* Component, UPersistenceManager& Manager) const
 {
+	PERSISTENCE_TRACE_SCOPE(Persistence_LoadData);
+
 	// If this goes off we're somehow loading data when this container hasn't been unpacked. Was the level load missed
 	// somehow?
-	ensure(Blob.Data.Num() == 0 || Header.IsUnpacked());
+	ensure(GetData().GetSize() == 0 || Header.IsUnpacked());
 
-	const FInfo* ActorInfo = Header.Info.FindByPredicate([=](const FInfo& RHS) { return Component->UniqueId == RHS.UniqueId; });
+	const int32* InfoIndex = Header.IdLookup.Find(Component->UniqueId);
 
 	// If we found saved info for this actor, create a reader for that section of the raw data and read it in.
-	if (ActorInfo)
+	if (InfoIndex != nullptr && *InfoIndex != INDEX_NONE)
 	{
-		FMemoryReaderView Ar(FMemoryView(&Blob.Data[ActorInfo->Offset], ActorInfo->Length));
-		Header.InitArchive(Ar);
-		ReadData(Component, Manager, Ar);
+		const FInfo& ActorInfo = Header.Info[*InfoIndex];
+
+		if (Header.Version >= 4 && !(ReadContext.IsValid() && ReadContext->bInUse))
+		{
+			if (!ReadContext.IsValid())
+			{
+				ReadContext = MakeUnique<FReadContext>(GetData(), Header);
+			}
+
+			ReadContext->bInUse = true;
+
+			// The reader covers the whole container, so limit the sub archive to this actor's data. Reading past the end
+			// of it flags the archives as errored and reads zeros, which shouldn't carry over to the next actor.
+			ReadContext->SubAr.ClearError();
+			ReadContext->PAr.ClearError();
+
+			ReadContext->Reader.Seek(ActorInfo.Offset);
+			ReadContext->SubAr.Rebase();
+			ReadContext->SubAr.SetLimit(ActorInfo.Length);
+			ReadContext->PAr.Reset();
+			ReadData(Component, Manager, ReadContext->SubAr, &ReadContext->PAr);
+
+			UE_CLOG(ReadContext->SubAr.IsError() || ReadContext->PAr.IsError(), LogGunfireSaveSystem, Warning, TEXT("Saved data for actor '%s' is corrupt or doesn't match its classes"),
+				*Component->GetOwner()->GetActorNameOrLabel());
+
+			ReadContext->bInUse = false;
+		}
+		else
+		{
+			FMemoryReaderView Ar(GetData().Mid(ActorInfo.Offset, ActorInfo.Length));
+			Header.InitArchive(Ar);
+
+			if (Header.Version >= 4)
+			{
+				FSaveGameArchive PAr(Ar, const_cast<FNameCache&>(Header.NameCache), Header.ArchiveVersion);
+				ReadData(Component, Manager, Ar, &PAr);
+			}
+			else
+			{
+				ReadData(Component, Manager, Ar, nullptr);
+			}
+		}
 	}
 	// Otherwise, check if it's been marked as destroyed
-	else if (Header.Destroyed.Contains(Component->UniqueId))
+	else if (InfoIndex != nullptr)
 	{
 		UE_LOG(LogGunfireSaveSystem, Verbose, TEXT("UPersistenceContainer - Attempted load for persistently destroyed actor '%s'"), *(Component->GetOwner()->GetActorNameOrLabel()));
 
@@ -442,32 +885,201 @@ void UPersistenceContainer::LoadData(UPersistenceComponent* Component, UPersiste
 	}
 }
 
-void UPersistenceContainer::WriteData(UPersistenceComponent* Component, UPersistenceManager& Manager, FArchive& Ar)
+void FPersistenceContainer::WriteData(UPersistenceComponent* Component, UPersistenceManager& Manager, FArchive& Ar, FSaveGameArchive& PAr)
 {
 	AActor* Actor = Component->GetOwner();
 
 	// Store transform
-	bool SaveTransform = Component->PersistTransform;
-	Ar << SaveTransform;
-	if (SaveTransform)
+	if (Component->PersistTransform)
 	{
 		FTransform Transform = Actor->GetTransform();
 
 		// Remove offset if there is a level offset
 		Manager.RemoveLevelOffset(Actor->GetLevel(), Transform);
 
-		Ar << Transform;
+		EPersistenceTransformEncoding Encoding = UPersistenceUtils::GetTransformEncoding(Transform, UseCompactTransform(Component));
+		Ar << Encoding;
+		UPersistenceUtils::SerializeTransform(Ar, Transform, Encoding);
+	}
+	else
+	{
+		EPersistenceTransformEncoding Encoding = EPersistenceTransformEncoding::None;
+		Ar << Encoding;
 	}
 
 	// Write Actor Data.
+	PAr.SetNoDelta(Component->HasModifiedSaveValues);
+	PAr.WriteBaseObject(Actor, Manager.GetClassCache());
+}
+
+bool FPersistenceContainer::ReadTransform(FArchive& Ar, const FHeader& InHeader, FTransform& Transform)
+{
+	// Older containers just stored a flag for whether the full transform was written
+	EPersistenceTransformEncoding Encoding = EPersistenceTransformEncoding::None;
+
+	if (InHeader.Version >= 3)
+	{
+		Ar << Encoding;
+	}
+	else
+	{
+		bool SaveTransform;
+		Ar << SaveTransform;
+
+		Encoding = SaveTransform ? EPersistenceTransformEncoding::Full : EPersistenceTransformEncoding::None;
+	}
+
+	if (Encoding != EPersistenceTransformEncoding::None)
+	{
+		UPersistenceUtils::SerializeTransform(Ar, Transform, Encoding);
+		return true;
+	}
+
+	return false;
+}
+
+void FPersistenceContainer::ReadDynamicActor(FArchive& Ar, const FHeader& InHeader, FGuid& UniqueId, FTransform& Transform, FTopLevelAssetPath& ClassPath)
+{
+	if (InHeader.HasCompactIds())
+	{
+		uint32 InfoIndex = 0;
+		Ar.SerializeIntPacked(InfoIndex);
+
+		if (InHeader.Info.IsValidIndex(InfoIndex))
+		{
+			UniqueId = InHeader.Info[InfoIndex].UniqueId;
+		}
+	}
+	else
+	{
+		Ar << UniqueId;
+	}
+
+	EPersistenceTransformEncoding Encoding = EPersistenceTransformEncoding::Full;
+	if (InHeader.Version >= 3)
 	{
-		FSaveGameArchive PAr(Ar, &Header.NameCache);
-		PAr.SetNoDelta(Component->HasModifiedSaveValues);
-		PAr.WriteBaseObject(Actor, Manager.GetClassCache());
+		Ar << Encoding;
 	}
+	UPersistenceUtils::SerializeTransform(Ar, Transform, Encoding);
+
+	Ar << ClassPath;
 }
 
-void UPersistenceContainer::ReadData(UPersistenceComponent* Component, UPersistenceManager& Manager, FArchive& Ar) const
+void FPersistenceContainer::DescribeSize(FPersistenceSizeReport& Report) const
+{
+	using ECategory = FPersistenceSizeReport::ECategory;
+
+	const FMemoryView Data = GetData();
+
+	Report.Add(ECategory::Container, Key.ToString(), Data.GetSize());
+
+	if (Data.GetSize() == 0)
+	{
+		return;
+	}
+
+	// Parse our own copy of the header, so we don't disturb the state of an unpacked container. Packed containers and
+	// offline reports don't have a manifest, so destroyed actors stored against one are only counted by size.
+	FHeader LocalHeader;
+	FMemoryReaderView Ar(Data, true);
+	LocalHeader.Serialize(Ar, nullptr, true);
+	LocalHeader.InitArchive(Ar);
+
+	const int64 FixedHeaderSize = Ar.Tell();
+
+	// The name cache is the last thing in the index, find out how big it is by writing it back out
+	TArray<uint8> NameCacheBytes;
+	FMemoryWriter NameCacheWriter(NameCacheBytes);
+	LocalHeader.NameCache.Serialize(NameCacheWriter);
+
+	Report.Add(ECategory::Overhead, TEXT("Container Header"), FixedHeaderSize);
+	Report.Add(ECategory::Overhead, TEXT("Container Index"), Data.GetSize() - LocalHeader.IndexOffset - NameCacheBytes.Num() - LocalHeader.ManifestDestroyedSize);
+
+	if (LocalHeader.ManifestDestroyedSize > 0)
+	{
+		Report.Add(ECategory::Overhead, TEXT("Manifest Destroyed Actors"), LocalHeader.ManifestDestroyedSize);
+	}
+	Report.Add(ECategory::Overhead, TEXT("Container Name Cache"), NameCacheBytes.Num());
+	Report.Add(ECategory::Overhead, TEXT("Dynamic Actor Table"), LocalHeader.IndexOffset - LocalHeader.DynamicOffset);
+
+	// The only place the class of a dynamic actor is stored is the dynamic actor table
+	TMap<FGuid, FString> DynamicClasses;
+
+	Ar.Seek(LocalHeader.DynamicOffset);
+
+	int32 NumDynamicActors;
+	Ar << NumDynamicActors;
+
+	for (int32 i = 0; i < NumDynamicActors && !Ar.IsError(); i++)
+	{
+		FGuid UniqueId;
+		FTransform Transform;
+		FTopLevelAssetPath ClassPath;
+		ReadDynamicActor(Ar, LocalHeader, UniqueId, Transform, ClassPath);
+
+		DynamicClasses.Add(UniqueId, ClassPath.GetAssetName().ToString());
+	}
+
+	TSet<uint32> DescribedOffsets;
+
+	for (const FInfo& CurInfo : LocalHeader.Info)
+	{
+		if (static_cast<uint64>(CurInfo.Offset) + CurInfo.Length > Data.GetSize())
+		{
+			UE_LOG(LogGunfireSaveSystem, Warning, TEXT("Container '%s' has an actor record past the end of its data"), *Key.ToString());
+			continue;
+		}
+
+		// Deduplicated records all point at the same data, so only count it once
+		bool bAlreadyDescribed = false;
+		DescribedOffsets.Add(CurInfo.Offset, &bAlreadyDescribed);
+
+		if (bAlreadyDescribed)
+		{
+			Report.Add(ECategory::Overhead, TEXT("Deduplicated Actor Records"), 0);
+			continue;
+		}
+
+		FString ClassName;
+
+		if (const FString* DynamicClass = DynamicClasses.Find(CurInfo.UniqueId))
+		{
+			ClassName = *DynamicClass;
+		}
+		else if (Report.ResolveActorClass)
+		{
+			ClassName = Report.ResolveActorClass(Key, CurInfo.UniqueId);
+		}
+
+		if (ClassName.IsEmpty())
+		{
+			ClassName = TEXT("Placed Actor");
+		}
+
+		Report.Add(ECategory::ActorClass, ClassName, CurInfo.Length);
+
+		FMemoryReaderView RecordAr(Data.Mid(CurInfo.Offset, CurInfo.Length));
+		LocalHeader.InitArchive(RecordAr);
+
+		FTransform Transform;
+		ReadTransform(RecordAr, LocalHeader, Transform);
+
+		Report.Add(ECategory::Property, FString::Printf(TEXT("%s.(transform)"), *ClassName), RecordAr.Tell());
+
+		if (LocalHeader.Version >= 4)
+		{
+			FSaveGameArchive PAr(RecordAr, LocalHeader.NameCache, LocalHeader.ArchiveVersion);
+			PAr.DescribeBaseObject(Report, ClassName);
+		}
+		else
+		{
+			FSaveGameArchive PAr(RecordAr, &LocalHeader.NameCache);
+			PAr.DescribeBaseObject(Report, ClassName);
+		}
+	}
+}
+
+void FPersistenceContainer::ReadData(UPersistenceComponent* Component, UPersistenceManager& Manager, FArchive& Ar, FSaveGameArchive* PAr) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_PersistenceGunfire_ContainerUnpack);
 
@@ -476,14 +1088,10 @@ void UPersistenceContainer::ReadData(UPersistenceComponent* Component, UPersiste
 	UE_LOG(LogGunfireSaveSystem, VeryVerbose, TEXT("Reading Actor '%s' [%s]"), *Actor->GetName(), *Actor->GetClass()->GetName());
 
 	// Read transform
-	bool SaveTransform;
-	Ar << SaveTransform;
+	FTransform Transform;
 
-	if (SaveTransform)
+	if (ReadTransform(Ar, Header, Transform))
 	{
-		FTransform Transform;
-		Ar << Transform;
-
 		// Add offset if there is an offset
 		Manager.AddLevelOffset(Actor->GetLevel(), Transform);
 
@@ -491,8 +1099,27 @@ void UPersistenceContainer::ReadData(UPersistenceComponent* Component, UPersiste
 	}
 
 	// Read Actor Data
+	if (PAr != nullptr)
 	{
-		FSaveGameArchive PAr(Ar, const_cast<FNameCache*>(&Header.NameCache));
-		PAr.ReadBaseObject(Actor);
+		PAr->ReadBaseObject(Actor);
 	}
+	else
+	{
+		FSaveGameArchive LegacyAr(Ar, const_cast<FNameCache*>(&Header.NameCache));
+		LegacyAr.ReadBaseObject(Actor);
+	}
+}
+
+void FPersistenceContainer::UpdateManifest(const UPersistenceComponent* Component)
+{
+	// Only level containers have a manifest, containers for actors with a save key can't use one.
+	if (!Manifest.IsValid() && Component->SaveKey.IsNone())
+	{
+		Manifest = UPersistenceLevelManifest::Get(Component->GetComponentLevel());
+	}
+}
+
+bool FPersistenceContainer::UseCompactTransform(const UPersistenceComponent* Component)
+{
+	return Component->CompactTransform || GetDefault<UGunfireSaveSystemSettings>()->CompactTransforms;
 }
@@ -4,23 +4,39 @@
 
 #include "CoreMinimal.h"
 #include "Containers/ArrayView.h"
+#include "Memory/MemoryView.h"
 #include "PersistenceTypes.h"
 #include "SaveGameArchive.h"
 
 #include "PersistenceContainer.generated.h"
 
 class UPersistenceComponent;
+class UPersistenceLevelManifest;
 class UPersistenceManager;
+class FPersistenceSaveData;
+struct FPersistenceSizeReport;
 
 //
 // A persistence container contains the save data for all actors in that container.
 // Typically a container corresponds to a level instance (per instance since a level could be loaded multiple times at
 // different offsets), but if a persistence component has a save key set a container will be created for just that actor.
 //
-UCLASS()
-class GUNFIRESAVESYSTEM_API UPersistenceContainer : public UObject
+// Containers aren't UObjects, since a save can have thousands of them and there's nothing in them the garbage collector
+// needs to know about. They're owned by the world save, which serializes them directly.
+//
+class GUNFIRESAVESYSTEM_API FPersistenceContainer : public TSharedFromThis<FPersistenceContainer>
 {
-	GENERATED_BODY()
+public:
+	FPersistenceContainer();
+	FPersistenceContainer(const FName& InKey, TArray<uint8>&& InData = TArray<uint8>());
+	~FPersistenceContainer();
+
+	FPersistenceContainer(const FPersistenceContainer&) = delete;
+	FPersistenceContainer& operator=(const FPersistenceContainer&) = delete;
+
+	// Serializes the key and packed save data. Any unpacked state is thrown away on load. If SaveData is the save being
+	// read from, the packed data is left in it and referenced in place instead of being copied out.
+	void Serialize(FArchive& Ar, const TSharedPtr<const FPersistenceSaveData>& SaveData = nullptr);
 
 protected:
 	struct FInfo
@@ -37,6 +53,15 @@ protected:
 		uint32 DynamicOffset = 0;
 		uint32 IndexOffset = 0;
 
+		// CONTAINER_FLAG_ values for how the rest of the container was written
+		uint32 Flags = 0;
+
+		// The FSaveGameArchive version all actor records were written with
+		int32 ArchiveVersion = 0;
+
+		// The size of the destroyed actors stored against the manifest, in the index. Only set when describing.
+		int64 ManifestDestroyedSize = 0;
+
 		// Lookup info for individual actors data, only valid when this persistence container is in use.
 		TArray<FInfo> Info;
 
@@ -49,12 +74,22 @@ protected:
 		// Unique names for all actors in this container
 		FNameCache NameCache;
 
+		// Maps actor ids to their index in Info (or INDEX_NONE if they're destroyed). This is rebuilt whenever the
+		// variable data is serialized, so it's only valid when this persistence container is in use.
+		TMap<FGuid, int32> IdLookup;
+
 		void Reset();
 
-		void Serialize(FArchive& Ar);
-		void SerializeVariable(FArchive& Ar);
+		// When loading with bDescribing set, the header is only being parsed for a size report, so destroyed actors stored
+		// against a manifest that isn't available aren't warned about. Their size is put in ManifestDestroyedSize.
+		void Serialize(FArchive& Ar, const UPersistenceLevelManifest* Manifest, bool bDescribing = false);
+		void SerializeVariable(FArchive& Ar, const UPersistenceLevelManifest* Manifest, bool bDescribing = false);
 
 		void InitArchive(FArchive& Ar) const;
+		void BuildIdLookup();
+
+		bool HasCompactIds() const;
+		bool HasManifestDestroyed() const;
 
 		bool IsUnpacked() const { return Info.Num() != 0 || Destroyed.Num() != 0; }
 		bool IsPacked() const { return Info.Num() == 0 && Destroyed.Num() == 0; }
@@ -64,13 +99,25 @@ public:
 	void SetKey(const FName& InKey) { Key = InKey; }
 	const FName& GetKey() const { return Key; }
 
+	// Sets the persistent actor manifest for the level this container is for. This needs to be set before unpacking,
+	// or any state that was stored against the manifest can't be read.
+	void SetManifest(const UPersistenceLevelManifest* InManifest) { Manifest = InManifest; }
+
 	void Pack();
+
+	// Parses the header and name table out of the packed data. This doesn't touch any UObjects (other than reading the
+	// manifest), so different containers can be unpacked on worker threads at the same time.
 	void Unpack();
 	bool IsUnpacked() const { return Header.IsUnpacked(); }
-	bool IsPacked() const { return Header.IsPacked() && Blob.Data.Num() > 0; }
+	bool IsPacked() const { return Header.IsPacked() && GetData().GetSize() > 0; }
 
 	bool HasDestroyed() const { return Header.Destroyed.Num() > 0; }
 
+	// Memory held by the packed data, and by the header and archives created when unpacking. Packed data that's still in
+	// the save it was loaded from is counted, even though that memory is shared.
+	SIZE_T GetPackedSize() const { return Blob.Data.GetAllocatedSize() + SharedView.GetSize(); }
+	SIZE_T GetUnpackedSize() const;
+
 	// Replaces the contents of the container with the save data from the specified components
 	void WriteData(TArrayView<TWeakObjectPtr<UPersistenceComponent>> Components, UPersistenceManager& Manager);
 
@@ -84,6 +131,9 @@ public:
 	bool IsPreloadingDynamicActors(bool bCheckDelegates = false) const;
 	bool HasSpawnedDynamicActors() const;
 
+	// The number of dynamic actors that have been preloaded but not spawned yet
+	int32 GetNumPendingDynamicActors() const { return NumPendingDynamicActors; }
+
 	// Called after a level is done loading, to spawn any persistent dynamic actors
 	bool SpawnDynamicActors(ULevel* Level, UPersistenceManager& Manager);
 
@@ -95,23 +145,71 @@ public:
 	// when this save game loads.
 	void SetDestroyed(UPersistenceComponent* Component);
 
+	// Adds the size of everything in this container to a report. This works off the packed data, so it can be called
+	// whether or not the container is unpacked.
+	void DescribeSize(FPersistenceSizeReport& Report) const;
+
+#if !UE_BUILD_SHIPPING
+	// For tools that work with containers directly, like the benchmark commandlet. Game code shouldn't need these.
+
+	// Adds the id of every actor record in an unpacked container
+	void GetActorIdsForTesting(TArray<FGuid>& OutIds) const
+	{
+		for (const FInfo& Info : Header.Info)
+		{
+			OutIds.Add(Info.UniqueId);
+		}
+	}
+
+	// Spawns the dynamic actors right away instead of preloading their classes first, so they must already be loaded
+	void SpawnDynamicActorsForTesting(ULevel* Level, UPersistenceManager& Manager) { SpawnDynamicActorsInternal(Level, Manager, true); }
+#endif
+
 protected:
-	void WriteData(UPersistenceComponent* Component, UPersistenceManager& Manager, FArchive& Ar);
-	void ReadData(UPersistenceComponent* Component, UPersistenceManager& Manager, FArchive& Ar) const;
+	void WriteData(UPersistenceComponent* Component, UPersistenceManager& Manager, FArchive& Ar, FSaveGameArchive& PAr);
+
+	// Reads the data for an actor. If PAr is null the record is from an older container that wrote a version for each
+	// actor, so a new archive will be created to read it.
+	void ReadData(UPersistenceComponent* Component, UPersistenceManager& Manager, FArchive& Ar, FSaveGameArchive* PAr) const;
 
 	void SpawnDynamicActorsInternal(ULevel* Level, UPersistenceManager& Manager, bool Spawn);
 
+	// Reads the transform at the start of an actor record, returning false if one wasn't saved
+	static bool ReadTransform(FArchive& Ar, const FHeader& InHeader, FTransform& Transform);
+
+	// Reads an entry from the dynamic actor table
+	static void ReadDynamicActor(FArchive& Ar, const FHeader& InHeader, FGuid& UniqueId, FTransform& Transform, FTopLevelAssetPath& ClassPath);
+
 	void OnDynamicActorsLoaded(ULevel* Level);
 
-	UPROPERTY(SaveGame, BlueprintReadOnly)
+	// Looks up the manifest for the component's level if we don't have one yet
+	void UpdateManifest(const UPersistenceComponent* Component);
+
+	// Returns true if transforms for this component should be quantized
+	static bool UseCompactTransform(const UPersistenceComponent* Component);
+
 	FName Key;
 
+	// The packed save data, either Blob or the part of the save this container was loaded from
+	FMemoryView GetData() const { return SharedSave.IsValid() ? SharedView : MakeMemoryView(Blob.Data); }
+
 	// All the save data is for a container is stored as a blob, so we only have to unpack it when it's actually needed.
-	UPROPERTY(SaveGame)
 	FPersistenceBlob Blob;
 
+	// When the container was loaded from a save, this is the save and SharedView is our data in it. These are released
+	// as soon as the container is written again.
+	TSharedPtr<const FPersistenceSaveData> SharedSave;
+	FMemoryView SharedView;
+
 	FHeader Header;
 
+	TWeakObjectPtr<const UPersistenceLevelManifest> Manifest;
+
+	// Archives for reading actor records, reused for all the actors in this container. This is created the first time
+	// an actor is loaded, and thrown away whenever the blob changes.
+	struct FReadContext;
+	mutable TUniquePtr<FReadContext> ReadContext;
+
 	// The unique id for the currently spawning actor
 	FGuid SpawningActorId;
 
@@ -126,4 +224,24 @@ protected:
 
 	EClassLoadState LoadState = EClassLoadState::Uninitialized;
 	TSharedPtr<struct FStreamableHandle> DynamicActorLoad;
+	int32 NumPendingDynamicActors = 0;
+};
+
+//
+// Containers used to be UObjects, this is only kept around so saves from before that change can still be loaded. The
+// world save converts these to FPersistenceContainers as soon as it's done loading.
+//
+UCLASS()
+class GUNFIRESAVESYSTEM_API UPersistenceContainer : public UObject
+{
+	GENERATED_BODY()
+
+	friend class USaveGameWorld;
+
+protected:
+	UPROPERTY(SaveGame)
+	FName Key;
+
+	UPROPERTY(SaveGame)
+	FPersistenceBlob Blob;
 };
@@ -0,0 +1,228 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceDelta.h"
+
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static const uint32 DeltaMagic = 0x544C4447;
+static const int32 DeltaVersion = 1;
+
+// The base is indexed in blocks of this size, so it's also the shortest match we'll find
+static const int32 DeltaBlockSize = 64;
+
+static const uint32 DeltaHashMultiplier = 0x01000193;
+
+static const uint8 DeltaOpEnd = 0;
+static const uint8 DeltaOpLiteral = 1;
+static const uint8 DeltaOpCopy = 2;
+
+static uint32 HashDeltaBlock(const uint8* Data)
+{
+	uint32 Hash = 0;
+
+	for (int32 i = 0; i < DeltaBlockSize; i++)
+	{
+		Hash = Hash * DeltaHashMultiplier + Data[i];
+	}
+
+	return Hash;
+}
+
+void FPersistenceDelta::Create(FMemoryView Base, FMemoryView Target, TArray<uint8>& OutDelta)
+{
+	const uint8* BaseData = static_cast<const uint8*>(Base.GetData());
+	const uint8* TargetData = static_cast<const uint8*>(Target.GetData());
+	const int64 BaseSize = static_cast<int64>(Base.GetSize());
+	const int64 TargetSize = static_cast<int64>(Target.GetSize());
+
+	OutDelta.Reset();
+
+	FMemoryWriter Ar(OutDelta);
+
+	uint32 Magic = DeltaMagic;
+	int32 Version = DeltaVersion;
+	uint32 BaseCrc = FCrc::MemCrc32(BaseData, static_cast<int32>(BaseSize));
+	uint32 TargetCrc = FCrc::MemCrc32(TargetData, static_cast<int32>(TargetSize));
+	int64 TargetSizeValue = TargetSize;
+
+	Ar << Magic;
+	Ar << Version;
+	Ar << BaseCrc;
+	Ar << TargetCrc;
+	Ar << TargetSizeValue;
+
+	// Index the start of every block in the base. If blocks repeat we only need one of them.
+	TMap<uint32, int64> BlockOffsets;
+	BlockOffsets.Reserve(static_cast<int32>(BaseSize / DeltaBlockSize));
+
+	for (int64 Offset = 0; Offset + DeltaBlockSize <= BaseSize; Offset += DeltaBlockSize)
+	{
+		BlockOffsets.FindOrAdd(HashDeltaBlock(BaseData + Offset), Offset);
+	}
+
+	// What the byte leaving the window was multiplied by, so it can be taken back out of the hash
+	uint32 OutgoingFactor = 1;
+
+	for (int32 i = 0; i < DeltaBlockSize - 1; i++)
+	{
+		OutgoingFactor *= DeltaHashMultiplier;
+	}
+
+	int64 LiteralStart = 0;
+
+	auto WriteLiteral = [&](int64 LiteralEnd)
+	{
+		if (LiteralEnd > LiteralStart)
+		{
+			uint8 Op = DeltaOpLiteral;
+			int64 Length = LiteralEnd - LiteralStart;
+
+			Ar << Op;
+			Ar << Length;
+			Ar.Serialize(const_cast<uint8*>(TargetData + LiteralStart), Length);
+		}
+	};
+
+	// Slide a block sized window over the target, looking for blocks that are in the base
+	int64 Pos = 0;
+	uint32 Hash = TargetSize >= DeltaBlockSize ? HashDeltaBlock(TargetData) : 0;
+
+	while (Pos + DeltaBlockSize <= TargetSize)
+	{
+		const int64* BaseOffset = BlockOffsets.Find(Hash);
+
+		if (BaseOffset != nullptr && FMemory::Memcmp(BaseData + *BaseOffset, TargetData + Pos, DeltaBlockSize) == 0)
+		{
+			int64 MatchBase = *BaseOffset;
+			int64 MatchTarget = Pos;
+			int64 MatchLength = DeltaBlockSize;
+
+			// Grow the match as far as it goes in both directions. Going backwards takes bytes off the pending literal.
+			while (MatchBase + MatchLength < BaseSize && MatchTarget + MatchLength < TargetSize &&
+				BaseData[MatchBase + MatchLength] == TargetData[MatchTarget + MatchLength])
+			{
+				MatchLength++;
+			}
+
+			while (MatchBase > 0 && MatchTarget > LiteralStart && BaseData[MatchBase - 1] == TargetData[MatchTarget - 1])
+			{
+				MatchBase--;
+				MatchTarget--;
+				MatchLength++;
+			}
+
+			WriteLiteral(MatchTarget);
+
+			uint8 Op = DeltaOpCopy;
+			Ar << Op;
+			Ar << MatchBase;
+			Ar << MatchLength;
+
+			Pos = MatchTarget + MatchLength;
+			LiteralStart = Pos;
+
+			if (Pos + DeltaBlockSize <= TargetSize)
+			{
+				Hash = HashDeltaBlock(TargetData + Pos);
+			}
+
+			continue;
+		}
+
+		if (Pos + DeltaBlockSize < TargetSize)
+		{
+			Hash = (Hash - TargetData[Pos] * OutgoingFactor) * DeltaHashMultiplier + TargetData[Pos + DeltaBlockSize];
+		}
+
+		Pos++;
+	}
+
+	WriteLiteral(TargetSize);
+
+	uint8 Op = DeltaOpEnd;
+	Ar << Op;
+}
+
+bool FPersistenceDelta::Apply(FMemoryView Base, FMemoryView Delta, TArray<uint8>& OutTarget)
+{
+	const uint8* BaseData = static_cast<const uint8*>(Base.GetData());
+	const int64 BaseSize = static_cast<int64>(Base.GetSize());
+
+	OutTarget.Reset();
+
+	FMemoryReaderView Ar(Delta);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint32 BaseCrc = 0;
+	uint32 TargetCrc = 0;
+	int64 TargetSize = 0;
+
+	Ar << Magic;
+	Ar << Version;
+	Ar << BaseCrc;
+	Ar << TargetCrc;
+	Ar << TargetSize;
+
+	if (Ar.IsError() || Magic != DeltaMagic || Version != DeltaVersion || TargetSize < 0 || TargetSize > MAX_int32)
+	{
+		return false;
+	}
+
+	if (FCrc::MemCrc32(BaseData, static_cast<int32>(BaseSize)) != BaseCrc)
+	{
+		return false;
+	}
+
+	OutTarget.Reserve(static_cast<int32>(TargetSize));
+
+	while (true)
+	{
+		uint8 Op = DeltaOpEnd;
+		Ar << Op;
+
+		if (Ar.IsError())
+		{
+			return false;
+		}
+
+		if (Op == DeltaOpEnd)
+		{
+			break;
+		}
+		else if (Op == DeltaOpLiteral)
+		{
+			int64 Length = 0;
+			Ar << Length;
+
+			if (Length < 0 || OutTarget.Num() + Length > TargetSize || Ar.Tell() + Length > Ar.TotalSize())
+			{
+				return false;
+			}
+
+			const int32 Start = OutTarget.AddUninitialized(static_cast<int32>(Length));
+			Ar.Serialize(OutTarget.GetData() + Start, Length);
+		}
+		else if (Op == DeltaOpCopy)
+		{
+			int64 Offset = 0;
+			int64 Length = 0;
+			Ar << Offset;
+			Ar << Length;
+
+			if (Offset < 0 || Length < 0 || Offset + Length > BaseSize || OutTarget.Num() + Length > TargetSize)
+			{
+				return false;
+			}
+
+			OutTarget.Append(BaseData + Offset, static_cast<int32>(Length));
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return !Ar.IsError() && OutTarget.Num() == TargetSize && FCrc::MemCrc32(OutTarget.GetData(), OutTarget.Num()) == TargetCrc;
+}
@@ -0,0 +1,21 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Memory/MemoryView.h"
+
+//
+// Binary deltas between two versions of a save, used to store older backups compactly. A delta rebuilds the target from
+// ranges copied out of the base plus literal bytes. Containers are written in a stable order, so two saves of the same
+// game mostly differ in a few containers and the delta is a small fraction of the save, even when data moves around.
+//
+struct GUNFIRESAVESYSTEM_API FPersistenceDelta
+{
+	// Creates a delta that rebuilds Target from Base
+	static void Create(FMemoryView Base, FMemoryView Target, TArray<uint8>& OutDelta);
+
+	// Rebuilds the target a delta was created for. Returns false if the delta is corrupt, or if Base isn't the data the
+	// delta was created against.
+	static bool Apply(FMemoryView Base, FMemoryView Delta, TArray<uint8>& OutTarget);
+};
@@ -0,0 +1,555 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceIOEngine.h"
+
+#include "PersistenceUtils.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+TAutoConsoleVariable<bool> CVarPersistenceIOUring(TEXT("SaveSystem.IOUring"), true, TEXT("Uses io_uring for reading and writing save files on Linux, if the kernel supports it"));
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class FBlockingPersistenceIOEngine final : public FPersistenceIOEngine
+{
+public:
+	virtual bool Execute(TArrayView<FPersistenceIORequest> Requests) override;
+	virtual const TCHAR* GetName() const override { return TEXT("Blocking"); }
+};
+
+bool FBlockingPersistenceIOEngine::Execute(TArrayView<FPersistenceIORequest> Requests)
+{
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+
+	bool bResult = true;
+
+	for (FPersistenceIORequest& Request : Requests)
+	{
+		if (Request.Type == FPersistenceIORequest::EType::Read)
+		{
+			Request.bSucceeded = FFileHelper::LoadFileToArray(*Request.ReadData, *Request.Path, FILEREAD_Silent);
+		}
+		else
+		{
+			PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Request.Path));
+
+			// Write a new file instead of truncating the old one, in case the old one is linked to another file
+			PlatformFile.DeleteFile(*Request.Path);
+
+			TUniquePtr<IFileHandle> File(PlatformFile.OpenWrite(*Request.Path));
+
+			Request.bSucceeded = File.IsValid() && File->Write(Request.WriteData.GetData(), Request.WriteData.Num());
+
+			if (Request.bSucceeded && Request.bFlush)
+			{
+				Request.bSucceeded = File->Flush(true);
+			}
+		}
+
+		bResult &= Request.bSucceeded;
+	}
+
+	return bResult;
+}
+
+FPersistenceIOEngine& FPersistenceIOEngine::GetBlocking()
+{
+	static FBlockingPersistenceIOEngine Engine;
+	return Engine;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if PLATFORM_LINUX
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+
+// The parts of the io_uring ABI we need. These are declared here instead of including <linux/io_uring.h>, since the
+// toolchain's sysroot can be older than io_uring. The ABI is stable, so these won't change.
+struct FIOUringSqe
+{
+	uint8 Opcode;
+	uint8 Flags;
+	uint16 IoPriority;
+	int32 Fd;
+	uint64 Offset;
+	uint64 Address;
+	uint32 Length;
+	uint32 OpFlags;
+	uint64 UserData;
+	uint64 Pad[3];
+};
+
+struct FIOUringCqe
+{
+	uint64 UserData;
+	int32 Result;
+	uint32 Flags;
+};
+
+struct FIOUringSqOffsets
+{
+	uint32 Head;
+	uint32 Tail;
+	uint32 RingMask;
+	uint32 RingEntries;
+	uint32 Flags;
+	uint32 Dropped;
+	uint32 Array;
+	uint32 Reserved1;
+	uint64 Reserved2;
+};
+
+struct FIOUringCqOffsets
+{
+	uint32 Head;
+	uint32 Tail;
+	uint32 RingMask;
+	uint32 RingEntries;
+	uint32 Overflow;
+	uint32 Cqes;
+	uint32 Flags;
+	uint32 Reserved1;
+	uint64 Reserved2;
+};
+
+struct FIOUringParams
+{
+	uint32 SqEntries;
+	uint32 CqEntries;
+	uint32 Flags;
+	uint32 SqThreadCpu;
+	uint32 SqThreadIdle;
+	uint32 Features;
+	uint32 WqFd;
+	uint32 Reserved[3];
+	FIOUringSqOffsets SqOffsets;
+	FIOUringCqOffsets CqOffsets;
+};
+
+static_assert(sizeof(FIOUringSqe) == 64, "io_uring submission entries are 64 bytes");
+static_assert(sizeof(FIOUringCqe) == 16, "io_uring completion entries are 16 bytes");
+static_assert(sizeof(FIOUringParams) == 120, "io_uring_params is 120 bytes");
+
+static const uint8 IOUringOpReadv = 1;
+static const uint8 IOUringOpWritev = 2;
+static const uint8 IOUringOpFsync = 3;
+
+static const uint32 IOUringEnterGetEvents = 1 << 0;
+static const uint32 IOUringFeatSingleMmap = 1 << 0;
+
+static const off_t IOUringOffSqRing = 0;
+static const off_t IOUringOffCqRing = 0x8000000;
+static const off_t IOUringOffSqes = 0x10000000;
+
+// The number of operations we keep in flight at once
+static const uint32 IOUringQueueDepth = 64;
+
+// Files are split into chunks of this size, so large files get more than one operation in flight
+static const uint64 IOUringChunkSize = 1024 * 1024;
+
+class FIOUringPersistenceIOEngine final : public FPersistenceIOEngine
+{
+public:
+	FIOUringPersistenceIOEngine();
+	virtual ~FIOUringPersistenceIOEngine() override;
+
+	virtual bool Execute(TArrayView<FPersistenceIORequest> Requests) override;
+	virtual const TCHAR* GetName() const override;
+
+private:
+	struct FOp
+	{
+		int32 Request = INDEX_NONE;
+		int32 Fd = -1;
+		uint8 Opcode = 0;
+		uint64 Offset = 0;
+		iovec Vec = {};
+	};
+
+	bool IsAvailable() const { return RingFd >= 0; }
+	void Shutdown();
+
+	// Adds operations to read or write Size bytes of a file, split up into chunks
+	static void AddChunks(TArray<FOp>& Ops, int32 Request, int32 Fd, uint8 Opcode, uint8* Data, uint64 Size);
+
+	// Submits all the operations, keeping as many in flight as the ring allows, and waits for them to finish. Short
+	// reads and writes are resubmitted for the rest of their data. Operations that fail mark their request in Failed.
+	// Returns false if the ring itself failed, in which case the state of the operations is unknown.
+	bool RunOps(TArray<FOp>& Ops, TArray<bool>& Failed);
+
+	int RingFd = -1;
+
+	void* SqRing = MAP_FAILED;
+	size_t SqRingSize = 0;
+	void* CqRing = MAP_FAILED;
+	size_t CqRingSize = 0;
+	FIOUringSqe* Sqes = static_cast<FIOUringSqe*>(MAP_FAILED);
+	size_t SqesSize = 0;
+
+	uint32* SqHead = nullptr;
+	uint32* SqTail = nullptr;
+	uint32* SqMask = nullptr;
+	uint32* SqArray = nullptr;
+	uint32 SqEntries = 0;
+
+	uint32* CqHead = nullptr;
+	uint32* CqTail = nullptr;
+	uint32* CqMask = nullptr;
+	FIOUringCqe* Cqes = nullptr;
+
+	// The ring can only be used by one thread at a time, and it may be shut down by whichever thread finds it broken
+	mutable FCriticalSection Lock;
+};
+
+FIOUringPersistenceIOEngine::FIOUringPersistenceIOEngine()
+{
+	FIOUringParams Params;
+	FMemory::Memzero(Params);
+
+	RingFd = static_cast<int>(syscall(__NR_io_uring_setup, IOUringQueueDepth, &Params));
+
+	// Older kernels won't have io_uring, and containers often block it
+	if (RingFd < 0)
+	{
+		UE_LOG(LogGunfireSaveSystem, Log, TEXT("io_uring isn't available (errno %d), save files will use blocking I/O"), errno);
+		return;
+	}
+
+	SqRingSize = Params.SqOffsets.Array + Params.SqEntries * sizeof(uint32);
+	CqRingSize = Params.CqOffsets.Cqes + Params.CqEntries * sizeof(FIOUringCqe);
+
+	const bool bSingleMmap = (Params.Features & IOUringFeatSingleMmap) != 0;
+
+	if (bSingleMmap)
+	{
+		SqRingSize = CqRingSize = FMath::Max(SqRingSize, CqRingSize);
+	}
+
+	SqRing = mmap(nullptr, SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IOUringOffSqRing);
+	CqRing = bSingleMmap ? SqRing : mmap(nullptr, CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IOUringOffCqRing);
+
+	SqesSize = Params.SqEntries * sizeof(FIOUringSqe);
+	Sqes = static_cast<FIOUringSqe*>(mmap(nullptr, SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IOUringOffSqes));
+
+	if (SqRing == MAP_FAILED || CqRing == MAP_FAILED || Sqes == MAP_FAILED)
+	{
+		UE_LOG(LogGunfireSaveSystem, Warning, TEXT("Couldn't map the io_uring rings (errno %d), save files will use blocking I/O"), errno);
+		Shutdown();
+		return;
+	}
+
+	uint8* SqBase = static_cast<uint8*>(SqRing);
+	SqHead = reinterpret_cast<uint32*>(SqBase + Params.SqOffsets.Head);
+	SqTail = reinterpret_cast<uint32*>(SqBase + Params.SqOffsets.Tail);
+	SqMask = reinterpret_cast<uint32*>(SqBase + Params.SqOffsets.RingMask);
+	SqArray = reinterpret_cast<uint32*>(SqBase + Params.SqOffsets.Array);
+	SqEntries = Params.SqEntries;
+
+	uint8* CqBase = static_cast<uint8*>(CqRing);
+	CqHead = reinterpret_cast<uint32*>(CqBase + Params.CqOffsets.Head);
+	CqTail = reinterpret_cast<uint32*>(CqBase + Params.CqOffsets.Tail);
+	CqMask = reinterpret_cast<uint32*>(CqBase + Params.CqOffsets.RingMask);
+	Cqes = reinterpret_cast<FIOUringCqe*>(CqBase + Params.CqOffsets.Cqes);
+}
+
+FIOUringPersistenceIOEngine::~FIOUringPersistenceIOEngine()
+{
+	Shutdown();
+}
+
+void FIOUringPersistenceIOEngine::Shutdown()
+{
+	if (Sqes != MAP_FAILED)
+	{
+		munmap(Sqes, SqesSize);
+		Sqes = static_cast<FIOUringSqe*>(MAP_FAILED);
+	}
+
+	if (CqRing != MAP_FAILED && CqRing != SqRing)
+	{
+		munmap(CqRing, CqRingSize);
+	}
+
+	CqRing = MAP_FAILED;
+
+	if (SqRing != MAP_FAILED)
+	{
+		munmap(SqRing, SqRingSize);
+		SqRing = MAP_FAILED;
+	}
+
+	// These all pointed into the mappings
+	SqHead = SqTail = SqMask = SqArray = nullptr;
+	SqEntries = 0;
+	CqHead = CqTail = CqMask = nullptr;
+	Cqes = nullptr;
+
+	if (RingFd >= 0)
+	{
+		close(RingFd);
+		RingFd = -1;
+	}
+}
+
+void FIOUringPersistenceIOEngine::AddChunks(TArray<FOp>& Ops, int32 Request, int32 Fd, uint8 Opcode, uint8* Data, uint64 Size)
+{
+	for (uint64 Offset = 0; Offset < Size; Offset += IOUringChunkSize)
+	{
+		FOp& Op = Ops.AddDefaulted_GetRef();
+		Op.Request = Request;
+		Op.Fd = Fd;
+		Op.Opcode = Opcode;
+		Op.Offset = Offset;
+		Op.Vec.iov_base = Data + Offset;
+		Op.Vec.iov_len = FMath::Min(IOUringChunkSize, Size - Offset);
+	}
+}
+
+bool FIOUringPersistenceIOEngine::RunOps(TArray<FOp>& Ops, TArray<bool>& Failed)
+{
+	TArray<int32> Pending;
+	Pending.Reserve(Ops.Num());
+
+	for (int32 i = Ops.Num() - 1; i >= 0; i--)
+	{
+		Pending.Add(i);
+	}
+
+	uint32 NumInFlight = 0;
+
+	while (Pending.Num() > 0 || NumInFlight > 0)
+	{
+		// Fill up the submission queue with as many pending operations as there's room for. The kernel only reads the
+		// tail and we're the only one writing it, so it doesn't need an atomic load.
+		uint32 Tail = *SqTail;
+
+		while (Pending.Num() > 0 && NumInFlight < SqEntries)
+		{
+			const int32 OpIndex = Pending.Pop(false);
+			FOp& Op = Ops[OpIndex];
+
+			const uint32 Index = Tail & *SqMask;
+
+			FIOUringSqe& Sqe = Sqes[Index];
+			FMemory::Memzero(Sqe);
+			Sqe.Opcode = Op.Opcode;
+			Sqe.Fd = Op.Fd;
+			Sqe.Offset = Op.Offset;
+			Sqe.UserData = static_cast<uint64>(OpIndex);
+
+			if (Op.Opcode != IOUringOpFsync)
+			{
+				Sqe.Address = reinterpret_cast<uint64>(&Op.Vec);
+				Sqe.Length = 1;
+			}
+
+			SqArray[Index] = Index;
+
+			Tail++;
+			NumInFlight++;
+		}
+
+		__atomic_store_n(SqTail, Tail, __ATOMIC_RELEASE);
+
+		// Submit anything the kernel hasn't picked up yet, and wait for at least one operation to finish
+		const uint32 NumToSubmit = Tail - __atomic_load_n(SqHead, __ATOMIC_ACQUIRE);
+
+		const long Ret = syscall(__NR_io_uring_enter, RingFd, NumToSubmit, 1, IOUringEnterGetEvents, nullptr, 0);
+
+		if (Ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+		{
+			UE_LOG(LogGunfireSaveSystem, Warning, TEXT("io_uring_enter failed (errno %d)"), errno);
+			return false;
+		}
+
+		uint32 Head = *CqHead;
+		const uint32 CqTailValue = __atomic_load_n(CqTail, __ATOMIC_ACQUIRE);
+
+		for (; Head != CqTailValue; Head++)
+		{
+			const FIOUringCqe& Cqe = Cqes[Head & *CqMask];
+			FOp& Op = Ops[static_cast<int32>(Cqe.UserData)];
+
+			NumInFlight--;
+
+			if (Op.Opcode == IOUringOpFsync)
+			{
+				Failed[Op.Request] |= Cqe.Result < 0;
+			}
+			// Reading nothing before the end of the chunk means the file got shorter since we checked its size
+			else if (Cqe.Result <= 0)
+			{
+				Failed[Op.Request] = true;
+			}
+			else if (static_cast<size_t>(Cqe.Result) < Op.Vec.iov_len)
+			{
+				Op.Offset += Cqe.Result;
+				Op.Vec.iov_base = static_cast<uint8*>(Op.Vec.iov_base) + Cqe.Result;
+				Op.Vec.iov_len -= Cqe.Result;
+
+				Pending.Add(static_cast<int32>(Cqe.UserData));
+			}
+		}
+
+		__atomic_store_n(CqHead, Head, __ATOMIC_RELEASE);
+	}
+
+	return true;
+}
+
+const TCHAR* FIOUringPersistenceIOEngine::GetName() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return IsAvailable() ? TEXT("io_uring") : TEXT("Blocking");
+}
+
+bool FIOUringPersistenceIOEngine::Execute(TArrayView<FPersistenceIORequest> Requests)
+{
+	// Another thread can shut the ring down, so it's only safe to check if it's available while holding the lock
+	FScopeLock ScopeLock(&Lock);
+
+	if (!IsAvailable() || !CVarPersistenceIOUring.GetValueOnAnyThread())
+	{
+		ScopeLock.Unlock();
+		return GetBlocking().Execute(Requests);
+	}
+
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+
+	TArray<int32> Fds;
+	Fds.Init(-1, Requests.Num());
+
+	TArray<bool> Failed;
+	Failed.Init(false, Requests.Num());
+
+	TArray<FOp> Ops;
+
+	// Opening files isn't worth going through the ring for, it's quick compared to the reads and writes
+	for (int32 i = 0; i < Requests.Num(); i++)
+	{
+		FPersistenceIORequest& Request = Requests[i];
+
+		if (Request.Type == FPersistenceIORequest::EType::Read)
+		{
+			const FString FullPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*Request.Path);
+			Fds[i] = open(TCHAR_TO_UTF8(*FullPath), O_RDONLY | O_CLOEXEC);
+
+			struct stat FileStat;
+			if (Fds[i] < 0 || fstat(Fds[i], &FileStat) != 0)
+			{
+				Failed[i] = true;
+				continue;
+			}
+
+			Request.ReadData->SetNumUninitialized(static_cast<int64>(FileStat.st_size));
+			AddChunks(Ops, i, Fds[i], IOUringOpReadv, Request.ReadData->GetData(), Request.ReadData->Num());
+		}
+		else
+		{
+			PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Request.Path));
+
+			// Write a new file instead of truncating the old one, in case the old one is linked to another file. If the
+			// old one can't be removed, O_EXCL makes the open fail rather than write through it.
+			const FString FullPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*Request.Path);
+			unlink(TCHAR_TO_UTF8(*FullPath));
+			Fds[i] = open(TCHAR_TO_UTF8(*FullPath), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+
+			if (Fds[i] < 0)
+			{
+				Failed[i] = true;
+				continue;
+			}
+
+			AddChunks(Ops, i, Fds[i], IOUringOpWritev, const_cast<uint8*>(Request.WriteData.GetData()), Request.WriteData.Num());
+		}
+	}
+
+	bool bRingWorked = RunOps(Ops, Failed);
+
+	// Once the data is written, flush all the files that need it at the same time
+	if (bRingWorked)
+	{
+		Ops.Reset();
+
+		for (int32 i = 0; i < Requests.Num(); i++)
+		{
+			if (Requests[i].Type == FPersistenceIORequest::EType::Write && Requests[i].bFlush && !Failed[i])
+			{
+				FOp& Op = Ops.AddDefaulted_GetRef();
+				Op.Request = i;
+				Op.Fd = Fds[i];
+				Op.Opcode = IOUringOpFsync;
+			}
+		}
+
+		bRingWorked = RunOps(Ops, Failed);
+	}
+
+	for (int32 Fd : Fds)
+	{
+		if (Fd >= 0)
+		{
+			close(Fd);
+		}
+	}
+
+	// If the ring is broken we can't tell what finished, so stop using it and redo everything with blocking I/O
+	if (!bRingWorked)
+	{
+		UE_LOG(LogGunfireSaveSystem, Warning, TEXT("io_uring failed, save files will use blocking I/O from now on"));
+		Shutdown();
+		ScopeLock.Unlock();
+
+		return GetBlocking().Execute(Requests);
+	}
+
+	bool bResult = true;
+
+	for (int32 i = 0; i < Requests.Num(); i++)
+	{
+		Requests[i].bSucceeded = !Failed[i];
+
+		if (Failed[i] && Requests[i].Type == FPersistenceIORequest::EType::Read)
+		{
+			Requests[i].ReadData->Reset();
+		}
+
+		bResult &= Requests[i].bSucceeded;
+	}
+
+	return bResult;
+}
+
+#endif // PLATFORM_LINUX
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FPersistenceIOEngine& FPersistenceIOEngine::Get()
+{
+#if PLATFORM_LINUX
+	static FIOUringPersistenceIOEngine Engine;
+	return Engine;
+#else
+	return GetBlocking();
+#endif
+}
@@ -0,0 +1,57 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//
+// A request to read or write a whole file, for FPersistenceIOEngine
+//
+struct FPersistenceIORequest
+{
+	enum class EType : uint8
+	{
+		Read,
+		Write,
+	};
+
+	EType Type = EType::Read;
+	FString Path;
+
+	// For reads, this is filled in with the contents of the file
+	TArray<uint8>* ReadData = nullptr;
+
+	// For writes, the new contents of the file. Any existing file is removed and replaced with a new one rather than
+	// written over, so files hard linked to it are never changed.
+	TConstArrayView<uint8> WriteData;
+
+	// For writes, whether the file should be flushed to storage before the request is finished
+	bool bFlush = false;
+
+	// Set when the request is finished
+	bool bSucceeded = false;
+};
+
+//
+// Reads and writes batches of whole files for the file save game system. On Linux this uses io_uring if the kernel
+// supports it, so all the files in a batch (and all the chunks of each file) are in flight at once, instead of being
+// read and written one after another. Everywhere else, or if io_uring isn't available or SaveSystem.IOUring is off,
+// the files are read and written one at a time with blocking I/O.
+//
+class GUNFIRESAVESYSTEM_API FPersistenceIOEngine
+{
+public:
+	virtual ~FPersistenceIOEngine() {}
+
+	// Runs all the requests and waits for them to finish. Returns true if all of them succeeded, otherwise check
+	// bSucceeded on each request. Files written by failed requests may be left partially written.
+	virtual bool Execute(TArrayView<FPersistenceIORequest> Requests) = 0;
+
+	virtual const TCHAR* GetName() const = 0;
+
+	// The best engine for this platform. This is safe to use from any thread.
+	static FPersistenceIOEngine& Get();
+
+	// The engine that does blocking I/O, for platforms without anything better and for comparing against
+	static FPersistenceIOEngine& GetBlocking();
+};
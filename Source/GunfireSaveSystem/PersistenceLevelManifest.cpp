@@ -0,0 +1,75 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceLevelManifest.h"
+
+#include "Engine/Level.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PersistenceLevelManifest)
+
+const UPersistenceLevelManifest* UPersistenceLevelManifest::Get(const ULevel* Level)
+{
+	if (Level != nullptr)
+	{
+		return const_cast<ULevel*>(Level)->GetAssetUserData<UPersistenceLevelManifest>();
+	}
+
+	return nullptr;
+}
+
+void UPersistenceLevelManifest::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildLookup();
+}
+
+int32 UPersistenceLevelManifest::FindActorIndex(const FGuid& UniqueId) const
+{
+	const int32* Index = ActorIndexLookup.Find(UniqueId);
+	return Index ? *Index : INDEX_NONE;
+}
+
+void UPersistenceLevelManifest::BuildLookup()
+{
+	ActorIndexLookup.Reset();
+	ActorIndexLookup.Reserve(ActorIds.Num());
+
+	for (int32 i = 0; i < ActorIds.Num(); i++)
+	{
+		ActorIndexLookup.Add(ActorIds[i], i);
+	}
+}
+
+#if WITH_EDITOR
+bool UPersistenceLevelManifest::Update(TArray<TPair<FGuid, FSoftClassPath>>& Actors, bool bReset)
+{
+	bool bChanged = false;
+
+	if (bReset || !ManifestId.IsValid())
+	{
+		ManifestId = FGuid::NewGuid();
+		ActorIds.Reset();
+		ActorClassIndices.Reset();
+		Classes.Reset();
+		ActorIndexLookup.Reset();
+
+		bChanged = true;
+	}
+
+	// Sort the new actors by id, so the manifest is deterministic no matter what order the level has them in.
+	Actors.Sort([](const TPair<FGuid, FSoftClassPath>& A, const TPair<FGuid, FSoftClassPath>& B) { return A.Key < B.Key; });
+
+	for (const TPair<FGuid, FSoftClassPath>& Actor : Actors)
+	{
+		if (!ActorIndexLookup.Contains(Actor.Key))
+		{
+			ActorIndexLookup.Add(Actor.Key, ActorIds.Add(Actor.Key));
+			ActorClassIndices.Add(Classes.AddUnique(Actor.Value));
+
+			bChanged = true;
+		}
+	}
+
+	return bChanged;
+}
+#endif
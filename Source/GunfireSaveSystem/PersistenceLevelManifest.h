@@ -0,0 +1,63 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/AssetUserData.h"
+
+#include "PersistenceLevelManifest.generated.h"
+
+//
+// A list of all the placed persistent actors in a level, generated offline by the PersistenceManifest commandlet and
+// stored as user data on the level. Since the index of each actor in the manifest never changes, containers can store
+// per-actor state for these actors (like whether it's been destroyed) as a bit per index instead of a full guid.
+//
+// The manifest is append-only. Actors that are added to the level are added to the end, and actors that are removed
+// keep their slot, so saves made with an older manifest can still be read. Resetting the manifest assigns it a new id,
+// and any state that was stored against the old manifest will be dropped on load.
+//
+UCLASS()
+class GUNFIRESAVESYSTEM_API UPersistenceLevelManifest : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	// Returns the manifest for a level, or null if it doesn't have one
+	static const UPersistenceLevelManifest* Get(const ULevel* Level);
+
+	virtual void PostLoad() override;
+
+	const FGuid& GetManifestId() const { return ManifestId; }
+
+	int32 NumActors() const { return ActorIds.Num(); }
+	const FGuid& GetActorId(int32 Index) const { return ActorIds[Index]; }
+	const FSoftClassPath& GetActorClass(int32 Index) const { return Classes[ActorClassIndices[Index]]; }
+
+	// Returns the manifest index for an actor, or INDEX_NONE if it isn't in the manifest
+	int32 FindActorIndex(const FGuid& UniqueId) const;
+
+#if WITH_EDITOR
+	// Adds any actors that aren't already in the manifest, returning true if anything changed. If bReset is set the
+	// existing entries are thrown away and the manifest is given a new id.
+	bool Update(TArray<TPair<FGuid, FSoftClassPath>>& Actors, bool bReset);
+#endif
+
+protected:
+	void BuildLookup();
+
+	// Identifies this version of the manifest, so state stored against an older reset manifest can be detected.
+	UPROPERTY()
+	FGuid ManifestId;
+
+	UPROPERTY()
+	TArray<FGuid> ActorIds;
+
+	// Index into Classes for each entry in ActorIds
+	UPROPERTY()
+	TArray<int32> ActorClassIndices;
+
+	// The unique classes of all the actors in the manifest
+	UPROPERTY()
+	TArray<FSoftClassPath> Classes;
+
+	TMap<FGuid, int32> ActorIndexLookup;
+};
@@ -2,25 +2,37 @@
 
 #include "PersistenceManager.h"
 
+#include "PersistenceCommitProfiler.h"
 #include "PersistenceComponent.h"
 #include "PersistenceContainer.h"
+#include "PersistenceLevelManifest.h"
+#include "PersistenceSaveData.h"
+#include "PersistenceSizeReport.h"
+#include "PersistenceTrace.h"
 #include "PersistenceUtils.h"
 #include "SaveGameArchive.h"
 #include "SaveGameProfile.h"
 #include "SaveGameWorld.h"
 
-#include "WindowsSaveGameSystem.h"
+#include "FileSaveGameSystem.h"
+#include "MemorySaveGameSystem.h"
+#include "ThrottledSaveGameSystem.h"
 
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Engine/AssetManager.h"
 #include "Engine/Engine.h"
 #include "Engine/LevelScriptActor.h"
 #include "Engine/LevelStreaming.h"
 #include "HAL/RunnableThread.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 #include "PlatformFeatures.h"
 #include "SaveGameSystem.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectWriter.h"
 
 #if WITH_EDITOR
 # include "Internationalization/Regex.h"
@@ -34,6 +46,14 @@ DECLARE_CYCLE_STAT(TEXT("Process Cached Loads"), STAT_PersistenceGunfire_Process
 DECLARE_CYCLE_STAT(TEXT("Compress Save"), STAT_PersistenceGunfire_CompressSave, STATGROUP_Persistence);
 DECLARE_CYCLE_STAT(TEXT("Decompress Save"), STAT_PersistenceGunfire_DecompressSave, STATGROUP_Persistence);
 
+LLM_DEFINE_TAG(Persistence);
+
+CSV_DEFINE_CATEGORY(Persistence, true);
+
+TRACE_DECLARE_INT_COUNTER(PersistenceWorldSaveBytes, TEXT("Persistence/World Save Bytes"));
+TRACE_DECLARE_INT_COUNTER(PersistenceProfileSaveBytes, TEXT("Persistence/Profile Save Bytes"));
+TRACE_DECLARE_FLOAT_COUNTER(PersistenceJobQueueWait, TEXT("Persistence/Job Queue Wait (ms)"));
+
 // Use different save names in PIE vs game, since on PC dev builds they'll output to the same spot
 #if WITH_EDITOR
 #define SAVE_PROFILE_NAME TEXT("editorprofile")
@@ -45,7 +65,76 @@ DECLARE_CYCLE_STAT(TEXT("Decompress Save"), STAT_PersistenceGunfire_DecompressSa
 
 // For debugging latency issues that only affect platforms with slow save systems
 TAutoConsoleVariable<float> CVarPersistenceJobDelay(TEXT("SaveSystem.JobDelay"), 0.f, TEXT("If this is greater than zero, all async persistence jobs will be delayed for that many seconds"), ECVF_Cheat);
-TAutoConsoleVariable<int32> CVarPersistenceDebug(TEXT("SaveSystem.Debug"), 0, TEXT("Prints on-screen messages about save operations"), ECVF_Cheat);
+TAutoConsoleVariable<int32> CVarPersistenceDebug(TEXT("SaveSystem.Debug"), 0, TEXT("Prints on-screen messages about save operations (1), and live persistence counters (2)"), ECVF_Cheat);
+TAutoConsoleVariable<FString> CVarPersistenceBackend(TEXT("SaveSystem.Backend"), TEXT("Platform"), TEXT("Where saves are stored: Platform (the platform save system), Memory (in memory only, lost on exit), or Throttled (the platform save system slowed down by the SaveSystem.Throttle settings). Ignored in shipping builds."), ECVF_Cheat);
+TAutoConsoleVariable<bool> CVarPersistenceMapSaves(TEXT("SaveSystem.MapSaves"), true, TEXT("Maps save files instead of reading them into memory, when the save system supports it. Saves must not be modified in place by anything else while they're mapped."));
+TAutoConsoleVariable<bool> CVarPersistenceCopyCommits(TEXT("SaveSystem.CopyCommits"), false, TEXT("When committing to a new slot with nothing changed since the last commit, copies the last committed save instead of writing everything out again"));
+TAutoConsoleVariable<bool> CVarPersistenceParallelUnpack(TEXT("SaveSystem.ParallelUnpack"), true, TEXT("Unpacks the containers for levels loaded together on worker threads"));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdPersistenceMemReport(
+	TEXT("SaveSystem.MemReport"),
+	TEXT("Prints a breakdown of the memory held by the save system"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		if (UPersistenceManager* Manager = UPersistenceManager::GetInstance(World))
+		{
+			Manager->DumpMemoryReport(Ar);
+		}
+		else
+		{
+			Ar.Logf(TEXT("No persistence manager for this world"));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdPersistenceSizeReport(
+	TEXT("SaveSystem.SizeReport"),
+	TEXT("Prints a breakdown of where the bytes in the current save are going. Usage: SaveSystem.SizeReport [File=<save file>] [Max=<entries per category>] [Csv]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		FString FilePath;
+		int32 MaxEntries = 20;
+		bool bCsv = false;
+
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("File="), FilePath);
+			FParse::Value(*Arg, TEXT("Max="), MaxEntries);
+			bCsv |= Arg.Equals(TEXT("Csv"), ESearchCase::IgnoreCase);
+		}
+
+		FPersistenceSizeReport Report;
+
+		if (!FilePath.IsEmpty())
+		{
+			TArray<uint8> SaveBlob;
+			if (!FFileHelper::LoadFileToArray(SaveBlob, *FilePath) || !UPersistenceManager::DescribeSave(SaveBlob, Report))
+			{
+				Ar.Logf(TEXT("Couldn't read save file '%s'"), *FilePath);
+				return;
+			}
+		}
+		else
+		{
+			UPersistenceManager* Manager = UPersistenceManager::GetInstance(World);
+			if (Manager == nullptr || !Manager->BuildSizeReport(Report))
+			{
+				Ar.Logf(TEXT("No current save to report on"));
+				return;
+			}
+		}
+
+		Report.Dump(Ar, MaxEntries);
+
+		if (bCsv)
+		{
+			const FString CsvPath = FPaths::ProfilingDir() / FString::Printf(TEXT("SaveSizeReport-%s.csv"), *FDateTime::Now().ToString());
+
+			if (FFileHelper::SaveStringToFile(Report.ToCsv(), *CsvPath))
+			{
+				Ar.Logf(TEXT("Wrote size report to '%s'"), *CsvPath);
+			}
+		}
+	}));
 
 // This version number is for changes to the persistence format at the top level. The persistence containers have their
 // own version, since they aren't guaranteed to be resaved each time the save game is (they may not be unpacked and
@@ -68,31 +157,35 @@ static const int32 GUNFIRE_PERSISTENCE_VERSION = 10;
 
 AActor* FPersistentReference::GetReference(UWorld* World)
 {
-	if (CachedActor)
-	{
-		return CachedActor;
-	}
-
 	if (Key.IsValid())
 	{
 		if (UPersistenceManager* Manager = UPersistenceManager::GetInstance(World))
 		{
-			return Manager->FindActorByKey(Key);
+			// If nothing has been registered or unregistered since we last resolved the key the cached result is still
+			// good (even if it's null). Otherwise, look it up again.
+			const uint32 Generation = Manager->GetRegistrationGeneration();
+			if (CachedGeneration != Generation)
+			{
+				CachedActor = Manager->FindActorByKey(Key);
+				CachedGeneration = Generation;
+			}
 		}
 	}
 
-	return nullptr;
+	return CachedActor.Get();
 }
 
 void FPersistentReference::SetReference(AActor* InActor)
 {
 	CachedActor = InActor;
+	CachedGeneration = 0;
 
 	if (InActor)
 	{
 		if (UPersistenceManager* Manager = UPersistenceManager::GetInstance(InActor->GetWorld()))
 		{
 			Key = Manager->GetActorKey(InActor);
+			CachedGeneration = Manager->GetRegistrationGeneration();
 			return;
 		}
 	}
@@ -104,12 +197,14 @@ void FPersistentReference::SetReference(AActor* InActor)
 void FPersistentReference::CopyReferenceFrom(const FPersistentReference& OtherReference)
 {
 	CachedActor = OtherReference.CachedActor;
+	CachedGeneration = OtherReference.CachedGeneration;
 	Key = OtherReference.Key;
 }
 
 void FPersistentReference::ClearReference()
 {
 	CachedActor = nullptr;
+	CachedGeneration = 0;
 	Key = FPersistenceKey();
 }
 
@@ -162,6 +257,8 @@ UPersistenceManager::UPersistenceManager()
 		ThreadHasWork = FGenericPlatformProcess::GetSynchEventFromPool();
 		Thread = FRunnableThread::Create(this, TEXT("PersistenceManager"), 128 * 1024);
 
+		LiveStatsTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::TickLiveStats));
+
 		// Add any levels that loaded before we were initialized (should just be the persistent level)
 		for (ULevel* Level : GetWorld()->GetLevels())
 		{
@@ -200,6 +297,9 @@ void UPersistenceManager::BeginDestroy()
 {
 	Super::BeginDestroy();
 
+	FTSTicker::GetCoreTicker().RemoveTicker(LiveStatsTickerHandle);
+	LiveStatsTickerHandle.Reset();
+
 	for (FThreadJob* Job : QueuedJobs)
 	{
 		Job->AsyncLoad->CancelHandle();
@@ -244,6 +344,8 @@ void UPersistenceManager::ResetPersistence()
 
 	CurrentSlot = -1;
 	CurrentData = nullptr;
+
+	MarkSaveDirty();
 }
 
 void UPersistenceManager::LoadProfileSave(FLoadSaveComplete Callback)
@@ -256,9 +358,11 @@ void UPersistenceManager::LoadProfileSave(FLoadSaveComplete Callback)
 
 void UPersistenceManager::LoadProfileSaveDone(const FThreadJob& Job, EPersistenceLoadResult Result)
 {
+	LiveStats.LastLoadLatencyMs = (FPlatformTime::Seconds() - Job.QueueTime) * 1000.0;
+
 	if (Result == EPersistenceLoadResult::Success || Result == EPersistenceLoadResult::Restored)
 	{
-		UserProfile = Cast<USaveGameProfile>(ReadSave(Job.ProfileData, Result));
+		UserProfile = Cast<USaveGameProfile>(ReadSave(Job.LoadedData.ToSharedRef(), Result));
 	}
 	else if (Result == EPersistenceLoadResult::DoesNotExist)
 	{
@@ -294,6 +398,8 @@ void UPersistenceManager::LoadSave(int32 Slot, FLoadSaveComplete Callback)
 	CurrentData = nullptr;
 	CurrentSlot = Slot;
 
+	MarkSaveDirty();
+
 	FThreadJob* Job = new FThreadJob;
 	Job->Type = EJobType::LoadSlot;
 	Job->LoadCallback = Callback;
@@ -303,9 +409,11 @@ void UPersistenceManager::LoadSave(int32 Slot, FLoadSaveComplete Callback)
 
 void UPersistenceManager::LoadSaveDone(const FThreadJob& Job, EPersistenceLoadResult Result)
 {
+	LiveStats.LastLoadLatencyMs = (FPlatformTime::Seconds() - Job.QueueTime) * 1000.0;
+
 	if (Result == EPersistenceLoadResult::Success || Result == EPersistenceLoadResult::Restored)
 	{
-		CurrentData = Cast<USaveGameWorld>(ReadSave(Job.WorldData, Result));
+		CurrentData = Cast<USaveGameWorld>(ReadSave(Job.LoadedData.ToSharedRef(), Result));
 	}
 	else if (Result == EPersistenceLoadResult::DoesNotExist)
 	{
@@ -331,7 +439,7 @@ void UPersistenceManager::ReadSaveDone(const FThreadJob& Job, EPersistenceLoadRe
 
 	if (Result == EPersistenceLoadResult::Success || Result == EPersistenceLoadResult::Restored)
 	{
-		SaveGame = Cast<USaveGameWorld>(ReadSave(Job.WorldData, Result));
+		SaveGame = Cast<USaveGameWorld>(ReadSave(Job.LoadedData.ToSharedRef(), Result));
 	}
 
 	Job.LoadCallback.ExecuteIfBound(Result, SaveGame);
@@ -359,6 +467,11 @@ void UPersistenceManager::DeleteSave(int32 Slot, FDeleteSaveComplete Callback)
 		ResetPersistence();
 	}
 
+	if (LastCommittedWorld.Slot == Slot)
+	{
+		LastCommittedWorld = FCommittedWorldSave();
+	}
+
 	FThreadJob* Job = new FThreadJob;
 	Job->Type = EJobType::DeleteSlot;
 	Job->DeleteCallback = Callback;
@@ -372,11 +485,28 @@ void UPersistenceManager::DeleteSaveDone(const FThreadJob& Job, bool Result)
 	OnDeleteGame.Broadcast(Result);
 }
 
+// Hashes the properties of a world save. This doesn't include its containers, since they're only written out by save
+// game archives.
+static uint32 HashWorldSaveProperties(USaveGameWorld* WorldSave)
+{
+	TArray<uint8> Bytes;
+	FObjectWriter Writer(WorldSave, Bytes);
+
+	return FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+}
+
 void UPersistenceManager::CommitSave(const FString& Reason, FCommitSaveComplete Callback)
+{
+	CommitSaveInternal(Reason, Callback, false);
+}
+
+void UPersistenceManager::CommitSaveInternal(const FString& Reason, FCommitSaveComplete Callback, bool bTryCopyWorld)
 {
 	check(IsInGameThread());
 
+	LLM_SCOPE_BYTAG(Persistence);
 	SCOPE_CYCLE_COUNTER(STAT_PersistenceGunfire_CommitSave);
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence CommitSave (slot %d)"), CurrentSlot);
 
 	if (bNeverCommit)
 	{
@@ -410,11 +540,16 @@ void UPersistenceManager::CommitSave(const FString& Reason, FCommitSaveComplete
 	const double CommitStartTime = FPlatformTime::Seconds();
 #endif
 
+	FPersistenceCommitProfiler Profiler;
+
 	FThreadJob* Job = new FThreadJob;
 	Job->Type = EJobType::Commit;
 	Job->SaveCallback = Callback;
 
-	OnPreSaveGame.Broadcast();
+	{
+		FPersistenceCommitPhaseScope PhaseScope(Profiler, TEXT("OnPreSaveGame listeners"));
+		OnPreSaveGame.Broadcast();
+	}
 
 	if (CVarPersistenceDebug.GetValueOnGameThread() > 0)
 	{
@@ -426,73 +561,63 @@ void UPersistenceManager::CommitSave(const FString& Reason, FCommitSaveComplete
 	if (CurrentData != nullptr)
 	{
 		// Let blueprint do any pre-commit updates to the data
-		CurrentData->PreCommit(this);
-		CurrentData->PreCommitNative(this);
-
-		TArray<FName, TInlineAllocator<16>> EmptyContainers;
-
-		// Go through all currently in use containers and have their actors write their latest save data.
-		for (auto It : RegisteredActors)
 		{
-			const FName& ContainerName = It.Key;
-			TArray<TWeakObjectPtr<UPersistenceComponent>>& Components = It.Value;
-
-			UPersistenceContainer* Container = GetContainer(ContainerName, false);
-
-			// If we've got registered components for this container, write them out now. It's possible to have a
-			// container with nothing to save if all the actors using it were moved to another container, or they were
-			// deleted and don't persist being destroyed.
-			if (Components.Num() > 0 || (Container && Container->HasDestroyed()))
-			{
-				if (!Container)
-				{
-					Container = GetContainer(ContainerName, true);
-				}
-
-				Container->WriteData(Components, *this);
-			}
-			// If a container is unused, don't bother writing anything for it and flag it for deletion.
-			else
-			{
-				EmptyContainers.Add(ContainerName);
-			}
+			FPersistenceCommitPhaseScope PhaseScope(Profiler, TEXT("World PreCommit"));
+			CurrentData->PreCommit(this);
 		}
-
-		// Now that we're done writing, remove any empty containers.
-		for (const FName& ContainerName : EmptyContainers)
 		{
-			if (DeleteContainer(ContainerName, false))
-			{
-				UE_LOG(LogGunfireSaveSystem, Log, TEXT("Deleting container '%s' because it's unused"), *FNameBuilder(ContainerName));
-			}
+			FPersistenceCommitPhaseScope PhaseScope(Profiler, TEXT("World PreCommitNative"));
+			CurrentData->PreCommitNative(this);
 		}
 
-		// Only allow the server to write out save games.
-		UWorld* World = GetGameInstance()->GetWorld();
-		if (CurrentData && World != nullptr && !World->IsNetMode(NM_Client))
+		if (!bTryCopyWorld)
 		{
-			if (CurrentSlot >= 0)
-			{
-				Job->Slot = CurrentSlot;
-				WriteSave(CurrentData, Job->WorldData);
-			}
-			else
-			{
-				UE_LOG(LogGunfireSaveSystem, Log, TEXT("CommitSave CurrentSlot == -1, bypassing WriteSave"));
-			}
+			WriteCurrentWorld(*Job, Profiler);
 		}
 	}
 
 	if (UserProfile)
 	{
-		UserProfile->PreCommit(this);
-		UserProfile->PreCommitNative(this);
+		{
+			FPersistenceCommitPhaseScope PhaseScope(Profiler, TEXT("Profile PreCommit"));
+			UserProfile->PreCommit(this);
+		}
+		{
+			FPersistenceCommitPhaseScope PhaseScope(Profiler, TEXT("Profile PreCommitNative"));
+			UserProfile->PreCommitNative(this);
+		}
 
 		// If we have profile data, always save it along with the world, even if you are a client connected to a servers
 		// game.
+		FPersistenceCommitPhaseScope PhaseScope(Profiler, TEXT("Write profile save"));
 		WriteSave(UserProfile, Job->ProfileData);
 	}
 
+	const uint32 ProfileHash = CVarPersistenceCopyCommits.GetValueOnGameThread() ? FCrc::MemCrc32(Job->ProfileData.GetData(), Job->ProfileData.Num()) : 0;
+
+	// Now that the hooks have run and the profile is written, check if the world save from the last commit is still
+	// good. If it is, copy it to the new slot instead of writing it out again, otherwise write it like usual.
+	if (bTryCopyWorld)
+	{
+		if (CanCopyLastCommit(ProfileHash))
+		{
+			UE_LOG(LogGunfireSaveSystem, Log, TEXT("Nothing has changed since slot %d was committed, copying it to slot %d"), LastCommittedWorld.Slot, CurrentSlot);
+
+			Job->Type = EJobType::CopySlot;
+			Job->Slot = CurrentSlot;
+			Job->SourceSlot = LastCommittedWorld.Slot;
+			Job->CommittedWorld = LastCommittedWorld;
+			Job->CommittedWorld.Slot = CurrentSlot;
+		}
+		else if (CurrentData != nullptr)
+		{
+			WriteCurrentWorld(*Job, Profiler);
+		}
+	}
+
+	TRACE_COUNTER_SET(PersistenceWorldSaveBytes, Job->WorldData.Num());
+	TRACE_COUNTER_SET(PersistenceProfileSaveBytes, Job->ProfileData.Num());
+
 #if !NO_LOGGING
 	const double CommitEndTime = FPlatformTime::Seconds();
 	UE_LOG(LogGunfireSaveSystem, Log, TEXT("Commit save done, world save %d KB, profile save %d KB, took %d ms. Pushing to thread"),
@@ -501,7 +626,102 @@ void UPersistenceManager::CommitSave(const FString& Reason, FCommitSaveComplete
 		static_cast<int32>((CommitEndTime - CommitStartTime) * 1000.0));
 #endif
 
+	const double CommitMs = Profiler.Finish(Reason);
+
+	LiveStats.RecentCommitTimes.Add(FPlatformTime::Seconds());
+	LiveStats.NumCommits++;
+	LiveStats.TotalCommitMs += CommitMs;
+	LiveStats.MaxCommitMs = FMath::Max(LiveStats.MaxCommitMs, CommitMs);
+	LiveStats.LastCommitBytes = Job->WorldData.Num() + Job->ProfileData.Num();
+
+	// Anything that changes the save data from here on has to be after what was just written
+	Job->CommittedWorld.SaveStateGeneration = SaveStateGeneration;
+	Job->CommittedWorld.RegistrationGeneration = RegistrationGeneration;
+	Job->CommittedWorld.ProfileHash = ProfileHash;
+
 	QueueJob(Job);
+
+	// The new save buffers are now counted as in flight, along with any older commits that haven't been written yet
+	LastCommitPeakBytes = JobBufferBytes;
+
+	if (CurrentData != nullptr)
+	{
+		for (const TSharedPtr<FPersistenceContainer>& Container : CurrentData->Containers)
+		{
+			LastCommitPeakBytes += Container->GetPackedSize() + Container->GetUnpackedSize();
+		}
+	}
+}
+
+void UPersistenceManager::WriteCurrentWorld(FThreadJob& Job, FPersistenceCommitProfiler& Profiler)
+{
+	const double WriteContainersStartTime = FPlatformTime::Seconds();
+
+	TArray<FName, TInlineAllocator<16>> EmptyContainers;
+
+	// Go through all currently in use containers and have their actors write their latest save data.
+	for (auto& It : RegisteredActors)
+	{
+		const FName& ContainerName = It.Key;
+		TArray<TWeakObjectPtr<UPersistenceComponent>>& Components = It.Value;
+
+		FPersistenceContainer* Container = GetContainer(ContainerName, false);
+
+		// If we've got registered components for this container, write them out now. It's possible to have a
+		// container with nothing to save if all the actors using it were moved to another container, or they were
+		// deleted and don't persist being destroyed.
+		if (Components.Num() > 0 || (Container && Container->HasDestroyed()))
+		{
+			if (!Container)
+			{
+				Container = GetContainer(ContainerName, true);
+			}
+
+			Container->WriteData(Components, *this);
+		}
+		// If a container is unused, don't bother writing anything for it and flag it for deletion.
+		else
+		{
+			EmptyContainers.Add(ContainerName);
+		}
+	}
+
+	// Now that we're done writing, remove any empty containers.
+	for (const FName& ContainerName : EmptyContainers)
+	{
+		if (DeleteContainer(ContainerName, false))
+		{
+			UE_LOG(LogGunfireSaveSystem, Log, TEXT("Deleting container '%s' because it's unused"), *FNameBuilder(ContainerName));
+		}
+	}
+
+	Profiler.AddPhase(TEXT("Write containers"), FPlatformTime::Seconds() - WriteContainersStartTime);
+
+	// Only allow the server to write out save games.
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (CurrentData && World != nullptr && !World->IsNetMode(NM_Client))
+	{
+		if (CurrentSlot >= 0)
+		{
+			FPersistenceCommitPhaseScope PhaseScope(Profiler, TEXT("Write world save"));
+
+			Job.Slot = CurrentSlot;
+			WriteSave(CurrentData, Job.WorldData);
+
+			Job.CommittedWorld.Slot = CurrentSlot;
+			Job.CommittedWorld.WorldTime = World->GetTimeSeconds();
+			Job.CommittedWorld.Data = CurrentData;
+
+			if (CVarPersistenceCopyCommits.GetValueOnGameThread())
+			{
+				Job.CommittedWorld.PropertiesHash = HashWorldSaveProperties(CurrentData);
+			}
+		}
+		else
+		{
+			UE_LOG(LogGunfireSaveSystem, Log, TEXT("CommitSave CurrentSlot == -1, bypassing WriteSave"));
+		}
+	}
 }
 
 void UPersistenceManager::CommitSaveDone(const FThreadJob& Job, EPersistenceSaveResult Result)
@@ -510,6 +730,12 @@ void UPersistenceManager::CommitSaveDone(const FThreadJob& Job, EPersistenceSave
 
 	--NumSavesPending;
 
+	// Remember what the slot was written from, so CommitSaveToSlot can tell if it's still up to date
+	if (Job.CommittedWorld.Slot >= 0)
+	{
+		LastCommittedWorld = Result == EPersistenceSaveResult::Success ? Job.CommittedWorld : FCommittedWorldSave();
+	}
+
 	Job.SaveCallback.ExecuteIfBound(Result);
 	OnSaveGame.Broadcast(Result);
 }
@@ -521,9 +747,36 @@ void UPersistenceManager::CommitSaveToSlot(int32 Slot, FCommitSaveComplete Callb
 		UE_LOG(LogGunfireSaveSystem, Display, TEXT("Changing current slot from %d to %d on commit"), CurrentSlot, Slot);
 	}
 
+	// Only copy a save that's known to be on storage. If a commit is still in flight it could fail.
+	const bool bTryCopyWorld = CVarPersistenceCopyCommits.GetValueOnGameThread() && NumSavesPending == 0;
+
 	CurrentSlot = Slot;
 
-	CommitSave(TEXT("Setting Slot"), Callback);
+	CommitSaveInternal(TEXT("Setting Slot"), Callback, bTryCopyWorld);
+}
+
+bool UPersistenceManager::CanCopyLastCommit(uint32 ProfileHash) const
+{
+	if (LastCommittedWorld.Slot < 0 || LastCommittedWorld.Slot == CurrentSlot || CurrentSlot < 0 || CurrentData == nullptr || LastCommittedWorld.Data != CurrentData)
+	{
+		return false;
+	}
+
+	if (LastCommittedWorld.SaveStateGeneration != SaveStateGeneration || LastCommittedWorld.RegistrationGeneration != RegistrationGeneration)
+	{
+		return false;
+	}
+
+	// Game code changes save data without telling us, so unless the game has been paused since the commit (or it's the
+	// same frame), assume something has changed. Clients never write the world save.
+	const UWorld* World = GetGameInstance()->GetWorld();
+	if (World == nullptr || World->IsNetMode(NM_Client) || World->GetTimeSeconds() != LastCommittedWorld.WorldTime)
+	{
+		return false;
+	}
+
+	// The pre-commit hooks can change either save directly, to stamp the time it was saved, say
+	return LastCommittedWorld.ProfileHash == ProfileHash && LastCommittedWorld.PropertiesHash == HashWorldSaveProperties(CurrentData);
 }
 
 void UPersistenceManager::HasProfileBackup(FDeleteSaveComplete Callback)
@@ -553,6 +806,11 @@ void UPersistenceManager::HasSlotBackup(int32 Slot, FDeleteSaveComplete Callback
 
 void UPersistenceManager::RestoreSlotBackup(int32 Slot, FDeleteSaveComplete Callback)
 {
+	if (LastCommittedWorld.Slot == Slot)
+	{
+		LastCommittedWorld = FCommittedWorldSave();
+	}
+
 	FThreadJob* Job = new FThreadJob;
 	Job->Type = EJobType::RestoreSlotBackup;
 	Job->DeleteCallback = Callback;
@@ -647,11 +905,14 @@ void UPersistenceManager::DeleteContainers(const FString& ContainerName, bool Su
 {
 	if (CurrentData != nullptr)
 	{
+		MarkSaveDirty();
+
 		if (SubstringMatch)
 		{
 			for (int i = CurrentData->Containers.Num() - 1; i >= 0; i--)
 			{
-				UPersistenceContainer* Container = CurrentData->Containers[i];
+				// Hold a reference, since the key is passed by reference to DeleteContainer which removes the container
+				const TSharedPtr<FPersistenceContainer> Container = CurrentData->Containers[i];
 
 				FNameBuilder CurContainerBuilder(Container->GetKey());
 				FStringView CurContainerName = CurContainerBuilder.ToView();
@@ -692,25 +953,21 @@ FPersistenceKey UPersistenceManager::GetActorKey(AActor* Actor) const
 
 AActor* UPersistenceManager::FindActorByKey(FPersistenceKey Key) const
 {
-	const TArray<TWeakObjectPtr<UPersistenceComponent>>* Components = RegisteredActors.Find(Key.ContainerKey);
+	const TWeakObjectPtr<UPersistenceComponent>* Component = RegisteredKeys.Find(Key);
 
 #if !UE_BUILD_SHIPPING
-	if (Components == nullptr)
+	if (Component == nullptr)
 	{
-		const FName QualifiedContainerKey = GetQualifiedContainerKey(Key.ContainerKey);
-		Components = RegisteredActors.Find(QualifiedContainerKey);
+		Key.ContainerKey = GetQualifiedContainerKey(Key.ContainerKey);
+		Component = RegisteredKeys.Find(Key);
 	}
 #endif
 
-	if (Components != nullptr)
+	if (Component != nullptr)
 	{
-		for (const TWeakObjectPtr<UPersistenceComponent>& Component : *Components)
+		if (const UPersistenceComponent* RawComponent = Component->Get())
 		{
-			const UPersistenceComponent* RawComponent = Component.Get();
-			if (RawComponent->UniqueId == Key.PersistentId)
-			{
-				return RawComponent->GetOwner();
-			}
+			return RawComponent->GetOwner();
 		}
 	}
 
@@ -730,11 +987,27 @@ void UPersistenceManager::Register(UPersistenceComponent* pComponent)
 	}
 #endif
 
+	LLM_SCOPE_BYTAG(Persistence);
+
 	const FName& ContainerKey = GetContainerKey(pComponent);
 
 	TArray<TWeakObjectPtr<UPersistenceComponent>>& Container = RegisteredActors.FindOrAdd(ContainerKey);
-	
-	Container.AddUnique(pComponent);
+
+	// The component tracks its own slot, so checking for a duplicate registration doesn't require a search.
+	if (Container.IsValidIndex(pComponent->RegisteredIndex) && Container[pComponent->RegisteredIndex] == pComponent)
+	{
+#if !UE_BUILD_SHIPPING
+		UE_LOG(LogGunfireSaveSystem, Warning, TEXT("Persistence component for actor %s registered twice (container %s)"),
+			*pComponent->GetOwner()->GetName(),
+			*ContainerKey.ToString());
+#endif
+		return;
+	}
+
+	pComponent->RegisteredIndex = Container.Emplace(pComponent);
+
+	RegisteredKeys.Add(FPersistenceKey(ContainerKey, pComponent->UniqueId), pComponent);
+	++RegistrationGeneration;
 
 #if !UE_BUILD_SHIPPING
 	if (!pComponent->SaveKey.IsNone() && Container.Num() > 1)
@@ -767,7 +1040,13 @@ void UPersistenceManager::Unregister(UPersistenceComponent* pComponent, ULevel*
 
 	if (TArray<TWeakObjectPtr<UPersistenceComponent>>* Components = RegisteredActors.Find(ContainerKey))
 	{
-		int NumRemoved = Components->Remove(pComponent);
+		int NumRemoved = RemoveRegisteredComponent(*Components, pComponent);
+
+		if (NumRemoved > 0)
+		{
+			RemoveRegisteredKey(ContainerKey, pComponent);
+			++RegistrationGeneration;
+		}
 
 		if (!pComponent->SaveKey.IsNone())
 		{
@@ -807,14 +1086,83 @@ void UPersistenceManager::Unregister(UPersistenceComponent* pComponent, ULevel*
 	}
 }
 
+int32 UPersistenceManager::RemoveRegisteredComponent(TArray<TWeakObjectPtr<UPersistenceComponent>>& Components, UPersistenceComponent* pComponent)
+{
+	int32 Index = pComponent->RegisteredIndex;
+
+	// The index should always point back at the component, but if it was registered to a different container than the
+	// one we're removing it from fall back to searching for it.
+	if (!Components.IsValidIndex(Index) || Components[Index] != pComponent)
+	{
+		Index = Components.Find(pComponent);
+
+		if (Index == INDEX_NONE)
+		{
+			return 0;
+		}
+	}
+
+	// Swap the last component into the removed slot. Order doesn't matter here, containers sort components by id
+	// before writing them out.
+	Components.RemoveAtSwap(Index, 1, false);
+
+	if (Components.IsValidIndex(Index))
+	{
+		if (UPersistenceComponent* MovedComponent = Components[Index].Get())
+		{
+			MovedComponent->RegisteredIndex = Index;
+		}
+	}
+
+	pComponent->RegisteredIndex = INDEX_NONE;
+
+	return 1;
+}
+
+void UPersistenceManager::ClearRegisteredComponents(const FName& ContainerKey)
+{
+	if (TArray<TWeakObjectPtr<UPersistenceComponent>>* Components = RegisteredActors.Find(ContainerKey))
+	{
+		for (const TWeakObjectPtr<UPersistenceComponent>& Component : *Components)
+		{
+			if (UPersistenceComponent* RawComponent = Component.Get())
+			{
+				RawComponent->RegisteredIndex = INDEX_NONE;
+				RemoveRegisteredKey(ContainerKey, RawComponent);
+			}
+		}
+
+		if (Components->Num() > 0)
+		{
+			++RegistrationGeneration;
+		}
+
+		RegisteredActors.Remove(ContainerKey);
+	}
+}
+
+void UPersistenceManager::RemoveRegisteredKey(const FName& ContainerKey, UPersistenceComponent* pComponent)
+{
+	const FPersistenceKey Key(ContainerKey, pComponent->UniqueId);
+
+	// Only remove the entry if it's actually for this component, in case something else registered with the same id
+	if (const TWeakObjectPtr<UPersistenceComponent>* Existing = RegisteredKeys.Find(Key))
+	{
+		if (*Existing == pComponent)
+		{
+			RegisteredKeys.Remove(Key);
+		}
+	}
+}
+
 FString UPersistenceManager::GetSlotName(int32 Slot)
 {
 	return FString::Printf(TEXT("%s_%d"), SAVE_SLOT_NAME, Slot);
 }
 
-UPersistenceContainer* UPersistenceManager::GetContainer(const UPersistenceComponent* Component)
+FPersistenceContainer* UPersistenceManager::GetContainer(const UPersistenceComponent* Component)
 {
-	UPersistenceContainer* Container = nullptr;
+	FPersistenceContainer* Container = nullptr;
 
 	if (!Component->GetWorld()->IsNetMode(NM_Client))
 	{
@@ -857,7 +1205,9 @@ UPersistenceContainer* UPersistenceManager::GetContainer(const UPersistenceCompo
 
 void UPersistenceManager::SetComponentDestroyed(UPersistenceComponent* Component)
 {
-	if (UPersistenceContainer* Container = GetContainer(GetContainerKey(Component), true))
+	MarkSaveDirty();
+
+	if (FPersistenceContainer* Container = GetContainer(GetContainerKey(Component), true))
 	{
 		UE_LOG(LogGunfireSaveSystem, Verbose, TEXT("UPersistenceManager - Setting component destroyed for container '%s'"), *FNameBuilder(Container->GetKey()));
 
@@ -871,81 +1221,269 @@ void UPersistenceManager::WriteComponent(UPersistenceComponent* Component)
 	{
 		if (ensure(!Component->SaveKey.IsNone()))
 		{
-			if (UPersistenceContainer* Container = GetContainer(GetContainerKey(Component), true))
+			if (FPersistenceContainer* Container = GetContainer(GetContainerKey(Component), true))
+			{
+				MarkSaveDirty();
+
+				TArray<TWeakObjectPtr<UPersistenceComponent>, TInlineAllocator<1>> Array;
+				Array.Emplace(Component);
+
+				Container->WriteData(Array, *this);
+			}
+		}
+	}
+}
+
+void UPersistenceManager::OnLevelChanged(UPersistenceComponent* pComponent, ULevel* OldLevel)
+{
+	// First, check if we should persist and don't have a save key. If we've got a save key we go into a special
+	// container, so we don't care what level we're in.
+	if (pComponent->ShouldPersist() && pComponent->SaveKey.IsNone())
+	{
+		// Dynamic unique id's are unique to the entire savegame, so we don't need to generate a new one. We don't
+		// support moving static persistent data though.
+		if (!pComponent->IsDynamic)
+		{
+			OutputUserMessage(
+				*FString::Printf(TEXT("Persistent actor in level %s is static, it needs to be dynamically spawned."), *OldLevel->GetLevelScriptActor()->GetName()),
+				pComponent->GetOwner());
+
+			return;
+		}
+
+		// If the container is packed it's not going to be saved again after this actor has been removed, which means
+		// it'll be duped next time we load that level. If this ever gets hit the solution is probably to get the actor
+		// moved over to the new level sooner.
+		if (const FName* LevelKey = LoadedLevels.Find(OldLevel))
+		{
+			if (FPersistenceContainer* Container = GetContainer(*LevelKey, false))
+			{
+				ensure(!Container->IsPacked());
+			}
+		}
+
+		// Unregister the component from the old container
+		Unregister(pComponent, OldLevel);
+
+		// Re-register the component to add it to the new container
+		Register(pComponent);
+	}
+}
+
+bool UPersistenceManager::HasSpawnedDynamicActorsForContainer(const FName& Name)
+{
+	if (FPersistenceContainer* Container = GetContainer(Name, false))
+	{
+		return Container->HasSpawnedDynamicActors();
+	}
+
+	return false;
+}
+
+void UPersistenceManager::ToBinary(UObject* Object, TArray<uint8>& ObjectBytes)
+{
+	FMemoryWriter MemoryWriter(ObjectBytes, true);
+
+	FSaveGameArchive Ar(MemoryWriter);
+	Ar.WriteBaseObject(Object, ClassCache);
+}
+
+void UPersistenceManager::FromBinary(UObject* Object, const TArray<uint8>& ObjectBytes)
+{
+	if (ObjectBytes.Num() == 0)
+		return;
+
+	FMemoryReader MemoryReader(ObjectBytes, true);
+
+	FSaveGameArchive Ar(MemoryReader);
+	Ar.ReadBaseObject(Object);
+}
+
+bool UPersistenceManager::BuildSizeReport(FPersistenceSizeReport& Report)
+{
+	if (CurrentData == nullptr)
+	{
+		return false;
+	}
+
+	// The class of placed actors isn't in the save, but any that are currently loaded can be looked up
+	if (!Report.ResolveActorClass)
+	{
+		Report.ResolveActorClass = [this](const FName& ContainerKey, const FGuid& ActorId)
+		{
+			FPersistenceKey Key;
+			Key.ContainerKey = ContainerKey;
+			Key.PersistentId = ActorId;
+
+			AActor* Actor = FindActorByKey(Key);
+			return Actor ? Actor->GetClass()->GetName() : FString();
+		};
+	}
+
+	TArray<uint8> SaveBlob;
+	WriteSave(CurrentData, SaveBlob);
+
+	return DescribeSave(SaveBlob, Report);
+}
+
+bool UPersistenceManager::DescribeSave(const TArray<uint8>& SaveBlob, FPersistenceSizeReport& Report)
+{
+	using ECategory = FPersistenceSizeReport::ECategory;
+
+	if (SaveBlob.Num() == 0)
+	{
+		return false;
+	}
+
+	FMemoryReader MemoryReader(SaveBlob, true);
+
+	FSaveHeader Header;
+	if (Header.Read(MemoryReader, MakeMemoryView(SaveBlob)) != EPersistenceLoadResult::Success)
+	{
+		return false;
+	}
+
+	const int64 DataStart = MemoryReader.Tell();
+
+	Report.SetSaveSize(Header.Size);
+	Report.Add(ECategory::Overhead, TEXT("Save Header"), DataStart);
+	Report.Add(ECategory::Overhead, TEXT("Save Custom Versions"), Header.Size - Header.CustomVersionsOffset);
+
+	// Walk the save object itself. The containers are written after its properties, so they'll show up as native data.
+	{
+		FSaveGameArchive Ar(MemoryReader);
+		Ar.DescribeBaseObject(Report, Header.SaveGameClassPath.GetAssetName().ToString());
+	}
+
+	UClass* SaveGameClass = FindObject<UClass>(Header.SaveGameClassPath);
+	if (SaveGameClass == nullptr)
+	{
+		SaveGameClass = LoadObject<UClass>(nullptr, *Header.SaveGameClassPath.ToString());
+	}
+
+	// To break down the containers we need to actually read the world save, since they're only accessible through it
+	if (SaveGameClass != nullptr && SaveGameClass->IsChildOf(USaveGameWorld::StaticClass()))
+	{
+		MemoryReader.Seek(DataStart);
+
+		USaveGameWorld* SaveGameWorld = NewObject<USaveGameWorld>(GetTransientPackage(), SaveGameClass);
+
+		FSaveGameArchive Ar(MemoryReader);
+		Ar.ReadBaseObject(SaveGameWorld);
+
+		SaveGameWorld->MigrateLegacyContainers();
+
+		for (const TSharedPtr<FPersistenceContainer>& Container : SaveGameWorld->Containers)
+		{
+			Container->DescribeSize(Report);
+		}
+	}
+
+	return true;
+}
+
+void UPersistenceManager::DumpMemoryReport(FOutputDevice& Ar) const
+{
+	int32 NumPacked = 0;
+	int32 NumUnpacked = 0;
+	SIZE_T PackedBytes = 0;
+	SIZE_T UnpackedBytes = 0;
+
+	if (CurrentData != nullptr)
+	{
+		for (const TSharedPtr<FPersistenceContainer>& Container : CurrentData->Containers)
+		{
+			if (Container->IsUnpacked())
+			{
+				NumUnpacked++;
+			}
+			else
 			{
-				TArray<TWeakObjectPtr<UPersistenceComponent>, TInlineAllocator<1>> Array;
-				Array.Emplace(Component);
-
-				Container->WriteData(Array, *this);
+				NumPacked++;
 			}
+
+			PackedBytes += Container->GetPackedSize();
+			UnpackedBytes += Container->GetUnpackedSize();
 		}
 	}
-}
 
-void UPersistenceManager::OnLevelChanged(UPersistenceComponent* pComponent, ULevel* OldLevel)
-{
-	// First, check if we should persist and don't have a save key. If we've got a save key we go into a special
-	// container, so we don't care what level we're in.
-	if (pComponent->ShouldPersist() && pComponent->SaveKey.IsNone())
+	SIZE_T RegisteredActorBytes = RegisteredActors.GetAllocatedSize();
+	for (const auto& It : RegisteredActors)
 	{
-		// Dynamic unique id's are unique to the entire savegame, so we don't need to generate a new one. We don't
-		// support moving static persistent data though.
-		if (!pComponent->IsDynamic)
-		{
-			OutputUserMessage(
-				*FString::Printf(TEXT("Persistent actor in level %s is static, it needs to be dynamically spawned."), *OldLevel->GetLevelScriptActor()->GetName()),
-				pComponent->GetOwner());
+		RegisteredActorBytes += It.Value.GetAllocatedSize();
+	}
 
-			return;
-		}
+	const SIZE_T RegisteredKeyBytes = RegisteredKeys.GetAllocatedSize();
+	const SIZE_T ClassCacheBytes = ClassCache.GetAllocatedSize();
+	const int64 InFlightBytes = JobBufferBytes;
 
-		// If the container is packed it's not going to be saved again after this actor has been removed, which means
-		// it'll be duped next time we load that level. If this ever gets hit the solution is probably to get the actor
-		// moved over to the new level sooner.
-		if (const FName* LevelKey = LoadedLevels.Find(OldLevel))
-		{
-			if (UPersistenceContainer* Container = GetContainer(*LevelKey, false))
-			{
-				ensure(!Container->IsPacked());
-			}
-		}
+	const SIZE_T TotalBytes = PackedBytes + UnpackedBytes + RegisteredActorBytes + RegisteredKeyBytes + ClassCacheBytes + InFlightBytes;
 
-		// Unregister the component from the old container
-		Unregister(pComponent, OldLevel);
+	Ar.Logf(TEXT("Persistence memory: %.1f KB"), TotalBytes / 1024.0);
+	Ar.Logf(TEXT("  Containers: %d packed, %d unpacked"), NumPacked, NumUnpacked);
+	Ar.Logf(TEXT("    Packed data:        %10.1f KB"), PackedBytes / 1024.0);
+	Ar.Logf(TEXT("    Unpacked headers:   %10.1f KB"), UnpackedBytes / 1024.0);
+	Ar.Logf(TEXT("  Job buffers:          %10.1f KB"), InFlightBytes / 1024.0);
+	Ar.Logf(TEXT("  Registered actors:    %10.1f KB (%d containers)"), RegisteredActorBytes / 1024.0, RegisteredActors.Num());
+	Ar.Logf(TEXT("  Registered keys:      %10.1f KB (%d keys)"), RegisteredKeyBytes / 1024.0, RegisteredKeys.Num());
+	Ar.Logf(TEXT("  Class cache:          %10.1f KB (%d classes)"), ClassCacheBytes / 1024.0, ClassCache.Num());
+	Ar.Logf(TEXT("  Peak during last commit: %.1f KB"), LastCommitPeakBytes / 1024.0);
 
-		// Re-register the component to add it to the new container
-		Register(pComponent);
+	// Saves held by the memory backend aren't counted in the total, since they're standing in for storage
+	if (GetSaveGameSystem() == &FMemorySaveGameSystem::Get())
+	{
+		Ar.Logf(TEXT("  Memory backend saves: %10.1f KB"), FMemorySaveGameSystem::Get().GetAllocatedSize() / 1024.0);
 	}
 }
 
-bool UPersistenceManager::HasSpawnedDynamicActorsForContainer(const FName& Name)
+#if !UE_BUILD_SHIPPING
+void UPersistenceManager::SetCurrentSaveForTesting(USaveGameWorld* SaveGame)
+{
+	CurrentData = SaveGame != nullptr ? SaveGame : CreateSaveGame();
+	CurrentSlot = INDEX_NONE;
+}
+
+void UPersistenceManager::WriteContainersForTesting()
 {
-	if (UPersistenceContainer* Container = GetContainer(Name, false))
+	for (TPair<FName, TArray<TWeakObjectPtr<UPersistenceComponent>>>& It : RegisteredActors)
 	{
-		return Container->HasSpawnedDynamicActors();
+		if (FPersistenceContainer* Container = GetContainer(It.Key, true))
+		{
+			Container->WriteData(It.Value, *this);
+		}
 	}
-
-	return false;
 }
 
-void UPersistenceManager::ToBinary(UObject* Object, TArray<uint8>& ObjectBytes)
+EPersistenceLoadResult UPersistenceManager::ReadSaveHeaderForTesting(FMemoryView SaveBlob)
 {
-	FMemoryWriter MemoryWriter(ObjectBytes, true);
+	FMemoryReaderView Reader(SaveBlob, true);
 
-	FSaveGameArchive Ar(MemoryWriter);
-	Ar.WriteBaseObject(Object, ClassCache);
+	FSaveHeader Header;
+	return Header.Read(Reader, SaveBlob);
 }
 
-void UPersistenceManager::FromBinary(UObject* Object, const TArray<uint8>& ObjectBytes)
+bool UPersistenceManager::ReplaceSavePayloadForTesting(TArray<uint8>& SaveBlob, TConstArrayView<uint8> Payload)
 {
-	if (ObjectBytes.Num() == 0)
-		return;
+	FSaveHeader Header;
 
-	FMemoryReader MemoryReader(ObjectBytes, true);
+	{
+		FMemoryReader Reader(SaveBlob);
+		if (Header.Read(Reader, MakeMemoryView(SaveBlob)) != EPersistenceLoadResult::Success)
+		{
+			return false;
+		}
+	}
 
-	FSaveGameArchive Ar(MemoryReader);
-	Ar.ReadBaseObject(Object);
+	SaveBlob.Reset();
+
+	FMemoryWriter Writer(SaveBlob);
+	Header.Write(Writer);
+	Writer.Serialize(const_cast<uint8*>(Payload.GetData()), Payload.Num());
+	Header.Finalize(Writer, SaveBlob);
+
+	return true;
 }
+#endif
 
 void UPersistenceManager::FSaveHeader::Write(FArchive& Ar)
 {
@@ -974,14 +1512,17 @@ void UPersistenceManager::FSaveHeader::Finalize(FArchive& Ar, const TArray<uint8
 	Ar.Seek(0);
 	Write(Ar);
 
-	Checksum = FCrc::MemCrc32(SaveBlob.GetData() + GetChecksumDataStartOffset(), Size - GetChecksumDataStartOffset());
+	{
+		PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence Checksum (%u bytes)"), Size);
+		Checksum = FCrc::MemCrc32(SaveBlob.GetData() + GetChecksumDataStartOffset(), Size - GetChecksumDataStartOffset());
+	}
 
 	// Now write the final data
 	Ar.Seek(0);
 	Write(Ar);
 }
 
-EPersistenceLoadResult UPersistenceManager::FSaveHeader::Read(FArchive& Archive, const TArray<uint8>& SaveBlob)
+EPersistenceLoadResult UPersistenceManager::FSaveHeader::Read(FArchive& Archive, FMemoryView SaveBlob)
 {
 	Archive << Version;
 
@@ -1006,12 +1547,17 @@ EPersistenceLoadResult UPersistenceManager::FSaveHeader::Read(FArchive& Archive,
 
 	// Some platforms will return extra padding bytes on load, so we write out the actual size we wrote. If it's greater
 	// than the amount of data read in it must be corrupt though.
-	if (Size > SaveBlob.Num())
+	if (Size > static_cast<int64>(SaveBlob.GetSize()) || Size < GetChecksumDataStartOffset())
 	{
 		return EPersistenceLoadResult::Corrupt;
 	}
 
-	const uint32 CalculatedCRC = FCrc::MemCrc32(SaveBlob.GetData() + GetChecksumDataStartOffset(), Size - GetChecksumDataStartOffset());
+	uint32 CalculatedCRC = 0;
+
+	{
+		PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence Checksum (%u bytes)"), Size);
+		CalculatedCRC = FCrc::MemCrc32(static_cast<const uint8*>(SaveBlob.GetData()) + GetChecksumDataStartOffset(), Size - GetChecksumDataStartOffset());
+	}
 
 	if (CalculatedCRC != Checksum)
 	{
@@ -1060,6 +1606,8 @@ int32 UPersistenceManager::FSaveHeader::GetChecksumDataStartOffset() const
 
 void UPersistenceManager::WriteSave(USaveGame* SaveGame, TArray<uint8>& SaveBlob)
 {
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence WriteSave %s"), *SaveGame->GetClass()->GetName());
+
 	SaveBlob.Reset();
 
 	FMemoryWriter MemoryWriter(SaveBlob, true);
@@ -1083,15 +1631,17 @@ void UPersistenceManager::WriteSave(USaveGame* SaveGame, TArray<uint8>& SaveBlob
 	Header.Finalize(MemoryWriter, SaveBlob);
 }
 
-bool UPersistenceManager::PreloadSave(FThreadJob& Job, const TArray<uint8>& SaveBlob)
+bool UPersistenceManager::PreloadSave(FThreadJob& Job, FMemoryView SaveBlob)
 {
-	if (SaveBlob.Num() == 0)
+	if (SaveBlob.GetSize() == 0)
 	{
 		return false;
 	}
 
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence PreloadSave (slot %d, %d bytes)"), Job.Slot, static_cast<int32>(SaveBlob.GetSize()));
+
 	// Load raw data from memory
-	FMemoryReader MemoryReader(SaveBlob, true);
+	FMemoryReaderView MemoryReader(SaveBlob, true);
 
 	FSaveHeader Header;
 	EPersistenceLoadResult Result = Header.Read(MemoryReader, SaveBlob);
@@ -1150,19 +1700,25 @@ void UPersistenceManager::OnSaveClassesLoaded(FThreadJob* Job)
 	});
 }
 
-USaveGame* UPersistenceManager::ReadSave(const TArray<uint8>& SaveBlob, EPersistenceLoadResult& Result)
+USaveGame* UPersistenceManager::ReadSave(const TSharedRef<const FPersistenceSaveData>& SaveData, EPersistenceLoadResult& Result)
 {
-	if (SaveBlob.Num() == 0)
+	const FMemoryView SaveBlob = SaveData->GetView();
+
+	if (SaveBlob.GetSize() == 0)
 	{
 		return nullptr;
 	}
 
+	LLM_SCOPE_BYTAG(Persistence);
+
 	// Load raw data from memory
-	FMemoryReader MemoryReader(SaveBlob, true);
+	FMemoryReaderView MemoryReader(SaveBlob, true);
 
 	// If this save has been restored, be sure to return that same status on success.
 	const bool bRestoredFromBackup = (Result == EPersistenceLoadResult::Restored);
 
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence ReadSave (%d bytes)"), static_cast<int32>(SaveBlob.GetSize()));
+
 	FSaveHeader Header;
 	Result = Header.Read(MemoryReader, SaveBlob);
 	if (Result != EPersistenceLoadResult::Success)
@@ -1188,26 +1744,42 @@ USaveGame* UPersistenceManager::ReadSave(const TArray<uint8>& SaveBlob, EPersist
 	}
 
 	USaveGame* SaveGame = NewObject<USaveGame>(GetTransientPackage(), SaveGameClass);
+	USaveGameWorld* SaveGameWorld = Cast<USaveGameWorld>(SaveGame);
+
+	// Let the containers point into the save instead of copying their data out of it
+	if (SaveGameWorld != nullptr)
+	{
+		SaveGameWorld->LoadingSaveData = SaveData;
+	}
 
 	FSaveGameArchive Ar(MemoryReader);
 	Ar.ReadBaseObject(SaveGame);
 
+	// Older saves will have their containers stored as objects, convert them now that everything is read in.
+	if (SaveGameWorld != nullptr)
+	{
+		SaveGameWorld->LoadingSaveData.Reset();
+		SaveGameWorld->MigrateLegacyContainers();
+	}
+
 	Result = bRestoredFromBackup ? EPersistenceLoadResult::Restored : EPersistenceLoadResult::Success;
 
 	return SaveGame;
 }
 
-bool UPersistenceManager::VerifySaveIntegrity(const TArray<uint8>& SaveBlob, EPersistenceLoadResult& Result)
+bool UPersistenceManager::VerifySaveIntegrity(FMemoryView SaveBlob, EPersistenceLoadResult& Result)
 {
 	// If no data exists at all, assume the save is corrupt.
-	if (SaveBlob.Num() == 0)
+	if (SaveBlob.GetSize() == 0)
 	{
 		Result = EPersistenceLoadResult::Corrupt;
 		return false;
 	}
 
 	// Load raw data from memory
-	FMemoryReader MemoryReader(SaveBlob, true);
+	FMemoryReaderView MemoryReader(SaveBlob, true);
+
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence ReadSave (%d bytes)"), static_cast<int32>(SaveBlob.GetSize()));
 
 	FSaveHeader Header;
 	Result = Header.Read(MemoryReader, SaveBlob);
@@ -1215,7 +1787,7 @@ bool UPersistenceManager::VerifySaveIntegrity(const TArray<uint8>& SaveBlob, EPe
 	return (Result == EPersistenceLoadResult::Success);
 }
 
-UPersistenceContainer* UPersistenceManager::GetContainer(const FName& Name, bool CreateIfMissing) const
+FPersistenceContainer* UPersistenceManager::GetContainer(const FName& Name, bool CreateIfMissing) const
 {
 	if (CurrentData != nullptr)
 	{
@@ -1223,25 +1795,18 @@ UPersistenceContainer* UPersistenceManager::GetContainer(const FName& Name, bool
 		const FName QualifiedContainerKey = GetQualifiedContainerKey(Name);
 #endif
 
-		for (UPersistenceContainer* Container : CurrentData->Containers)
+		for (const TSharedPtr<FPersistenceContainer>& Container : CurrentData->Containers)
 		{
-			// Encountering a null container originating from an old / invalid save.
-			if (Container == nullptr)
-			{
-				UE_LOG(LogGunfireSaveSystem, Error, TEXT("Null container encountered in current save data: '%s'"), *Name.ToString());
-				continue;
-			}
-
 			const FName& ContainerKey = Container->GetKey();
 			if (ContainerKey == Name)
 			{
-				return Container;
+				return Container.Get();
 			}
 
 #if !UE_BUILD_SHIPPING
 			if (ContainerKey == QualifiedContainerKey)
 			{
-				return Container;
+				return Container.Get();
 			}
 #endif
 		}
@@ -1250,10 +1815,7 @@ UPersistenceContainer* UPersistenceManager::GetContainer(const FName& Name, bool
 		{
 			UE_LOG(LogGunfireSaveSystem, Log, TEXT("Creating container '%s'"), *Name.ToString());
 
-			UPersistenceContainer* Container = NewObject<UPersistenceContainer>(CurrentData);
-			Container->SetKey(Name);
-			CurrentData->Containers.Emplace(Container);
-			return Container;
+			return CurrentData->Containers.Add_GetRef(MakeShared<FPersistenceContainer>(Name)).Get();
 		}
 	}
 
@@ -1296,16 +1858,15 @@ bool UPersistenceManager::DeleteContainer(const FName& ContainerName, bool Block
 	{
 		for (int i = CurrentData->Containers.Num() - 1; i >= 0; i--)
 		{
-			UPersistenceContainer* Container = CurrentData->Containers[i];
+			// Keep the container alive until we're done, in case ContainerName references its key
+			const TSharedPtr<FPersistenceContainer> Container = CurrentData->Containers[i];
 
 			if (Container->GetKey() == ContainerName)
 			{
-				RegisteredActors.Remove(ContainerName);
+				ClearRegisteredComponents(ContainerName);
 
 				CurrentData->Containers.RemoveAt(i);
 
-				Container->MarkAsGarbage();
-
 				// If we have a level loaded for this container, remove it from our list. That way we won't recreate the
 				// container we just deleted if a save is triggered before the level unloads. If the level is unloaded
 				// and then loaded again it will save though.
@@ -1332,7 +1893,7 @@ bool UPersistenceManager::DeleteContainer(const FName& ContainerName, bool Block
 void UPersistenceManager::PackContainer(const FName& LevelKey)
 {
 	// This container should be done being used at this point, so pack it until it's needed again.
-	if (UPersistenceContainer* Container = GetContainer(LevelKey, false))
+	if (FPersistenceContainer* Container = GetContainer(LevelKey, false))
 	{
 		Container->Pack();
 	}
@@ -1346,7 +1907,7 @@ void UPersistenceManager::PackContainer(const FName& LevelKey)
 #endif
 
 	// Remove the registered actors array for this container (should be empty at this point)
-	RegisteredActors.Remove(LevelKey);
+	ClearRegisteredComponents(LevelKey);
 }
 
 #if !UE_BUILD_SHIPPING
@@ -1396,7 +1957,7 @@ void UPersistenceManager::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
 			Key = *LevelScript->GetName();
 		}
 
-		UPersistenceContainer* Container = GetContainer(Key, false);
+		FPersistenceContainer* Container = GetContainer(Key, false);
 		if (Container == nullptr)
 		{
 			// Only allow the OnLevelPostLoad to be called if we know it is not yet tracked by the PersistenceManager.
@@ -1426,25 +1987,35 @@ void UPersistenceManager::OnLevelPostLoad(ULevel* Level, UWorld* World)
 		// Always check if this is actually our world. In PIE this callback will come in for all instances.
 		if (GetInstance(World) == this)
 		{
-			ensure(LoadedLevels.Find(Level) == nullptr);
-
-			// Cache off the level key, so we don't have to keep recomputing it every time an actor from this level is
-			// used.
-			const FName LevelKey(*Level->GetPathName());
-			LoadedLevels.Add(Level) = LevelKey;
-
-			if (UPersistenceContainer* Container = GetContainer(LevelKey, false))
+			if (FPersistenceContainer* Container = AddLoadedLevel(Level))
 			{
-				if (!Container->IsUnpacked())
-				{
-					Container->Unpack();
-					Container->PreloadDynamicActors(Level, *this);
-				}
+				Container->Unpack();
+				Container->PreloadDynamicActors(Level, *this);
 			}
 		}
 	}
 }
 
+FPersistenceContainer* UPersistenceManager::AddLoadedLevel(ULevel* Level)
+{
+	ensure(LoadedLevels.Find(Level) == nullptr);
+
+	// Cache off the level key, so we don't have to keep recomputing it every time an actor from this level is used.
+	const FName LevelKey(*Level->GetPathName());
+	LoadedLevels.Add(Level) = LevelKey;
+
+	if (FPersistenceContainer* Container = GetContainer(LevelKey, false))
+	{
+		if (!Container->IsUnpacked())
+		{
+			Container->SetManifest(UPersistenceLevelManifest::Get(Level));
+			return Container;
+		}
+	}
+
+	return nullptr;
+}
+
 void UPersistenceManager::OnPreWorldInitialization(UWorld* World, const UWorld::InitializationValues IVS)
 {
 	ProcessCachedLoads();
@@ -1470,7 +2041,7 @@ void UPersistenceManager::OnCanLevelActorsInitialize(ULevel* Level, UWorld* Worl
 
 		if (const FName* LevelKey = LoadedLevels.Find(Level))
 		{
-			if (UPersistenceContainer* Container = GetContainer(*LevelKey, false))
+			if (FPersistenceContainer* Container = GetContainer(*LevelKey, false))
 			{
 				if (Container->IsPreloadingDynamicActors(bCheckDelegates))
 				{
@@ -1489,12 +2060,14 @@ void UPersistenceManager::OnLevelActorsInitialized(ULevel* Level, UWorld* World)
 
 	if (GetInstance(World) == this && !World->IsNetMode(NM_Client))
 	{
+		PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence LevelActorsInitialized %s"), *Level->GetOutermost()->GetName());
+
 		bool SpawnedActors = true;
 
 		const FName* LevelKey = LoadedLevels.Find(Level);
 		if (LevelKey)
 		{
-			if (UPersistenceContainer* Container = GetContainer(*LevelKey, false))
+			if (FPersistenceContainer* Container = GetContainer(*LevelKey, false))
 			{
 				SpawnedActors = Container->SpawnDynamicActors(Level, *this);
 			}
@@ -1533,7 +2106,7 @@ void UPersistenceManager::OnLevelPreRemoveFromWorld(ULevel* Level, UWorld* World
 					// we don't need this container anymore and can remove it.
 					if (Components->Num() == 0)
 					{
-						UPersistenceContainer* Container = GetContainer(*LevelKey, false);
+						FPersistenceContainer* Container = GetContainer(*LevelKey, false);
 
 						if (!Container || !Container->HasDestroyed())
 						{
@@ -1548,7 +2121,7 @@ void UPersistenceManager::OnLevelPreRemoveFromWorld(ULevel* Level, UWorld* World
 
 					if (WriteContainer)
 					{
-						UPersistenceContainer* Container = GetContainer(*LevelKey, true);
+						FPersistenceContainer* Container = GetContainer(*LevelKey, true);
 						Container->WriteData(*Components, *this);
 						Container->Pack();
 					}
@@ -1673,7 +2246,13 @@ void UPersistenceManager::OnSuspend()
 
 void UPersistenceManager::ProcessCachedLoads()
 {
+	LLM_SCOPE_BYTAG(Persistence);
 	SCOPE_CYCLE_COUNTER(STAT_PersistenceGunfire_ProcessCachedLoads);
+	PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence ProcessCachedLoads (%d levels)"), CachedLoads.Num());
+
+	// Containers for all the levels we're processing that need to be unpacked. On initial map load this can be dozens
+	// of levels, so they're all collected up and unpacked together.
+	TArray<TPair<ULevel*, FPersistenceContainer*>, TInlineAllocator<32>> PendingUnpacks;
 
 	for (int32 i = 0; i < CachedLoads.Num(); ++i)
 	{
@@ -1682,16 +2261,42 @@ void UPersistenceManager::ProcessCachedLoads()
 		if (CachedLevel->OwningWorld->GetGameInstance() != nullptr)
 		{
 			// It's possible a load snuck in and registered this before we processed the cache, so if it's already there
-			// just skip it.
-			if (LoadedLevels.Find(CachedLevel) == nullptr)
+			// just skip it. Also check if this is actually our world, in PIE the cached loads come in for all instances.
+			if (LoadedLevels.Find(CachedLevel) == nullptr && GetInstance(CachedLevel->OwningWorld) == this)
 			{
-				OnLevelPostLoad(CachedLevel, CachedLevel->OwningWorld);
+				if (FPersistenceContainer* Container = AddLoadedLevel(CachedLevel))
+				{
+					PendingUnpacks.Emplace(CachedLevel, Container);
+				}
 			}
 
 			CachedLoads.RemoveAt(i);
 			i--;
 		}
 	}
+
+	// Unpacking only parses the container header and name table out of its own blob, so each container can be done on
+	// a separate worker.
+	if (PendingUnpacks.Num() > 1 && CVarPersistenceParallelUnpack.GetValueOnGameThread())
+	{
+		ParallelFor(PendingUnpacks.Num(), [&PendingUnpacks](int32 Index)
+		{
+			PendingUnpacks[Index].Value->Unpack();
+		});
+	}
+	else
+	{
+		for (const TPair<ULevel*, FPersistenceContainer*>& PendingUnpack : PendingUnpacks)
+		{
+			PendingUnpack.Value->Unpack();
+		}
+	}
+
+	// Kicking off the dynamic actor class loads touches UObjects, so that has to stay on the game thread.
+	for (const TPair<ULevel*, FPersistenceContainer*>& PendingUnpack : PendingUnpacks)
+	{
+		PendingUnpack.Value->PreloadDynamicActors(PendingUnpack.Key, *this);
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1752,6 +2357,90 @@ void UPersistenceManager::AddLevelOffset(ULevel* Level, FTransform& Transform)
 	}
 }
 
+bool UPersistenceManager::TickLiveStats(float DeltaTime)
+{
+	// Only keep the commits from the last minute around. This has to happen even when the stats aren't being shown,
+	// since every commit adds to the list.
+	const double Now = FPlatformTime::Seconds();
+	LiveStats.RecentCommitTimes.RemoveAll([Now](double CommitTime) { return Now - CommitTime > 60.0; });
+
+	const bool bShowOverlay = CVarPersistenceDebug.GetValueOnGameThread() >= 2 && GEngine != nullptr;
+
+#if CSV_PROFILER
+	const bool bCapturing = FCsvProfiler::Get()->IsCapturing();
+#else
+	const bool bCapturing = false;
+#endif
+
+	if (!bShowOverlay && !bCapturing)
+	{
+		return true;
+	}
+
+	const int32 CommitsPerMinute = LiveStats.RecentCommitTimes.Num();
+	const double AvgCommitMs = (LiveStats.NumCommits > 0) ? (LiveStats.TotalCommitMs / LiveStats.NumCommits) : 0.0;
+	const float QueueWaitMs = LastJobQueueWaitMs;
+
+	int32 NumQueuedJobs = QueuedJobs.Num();
+	{
+		FScopeLock Lock(&ThreadJobsLock);
+		NumQueuedJobs += ThreadJobs.Num();
+	}
+
+	int32 NumPacked = 0;
+	int32 NumUnpacked = 0;
+	int32 NumPendingDynamicActors = 0;
+
+	if (CurrentData != nullptr)
+	{
+		for (const TSharedPtr<FPersistenceContainer>& Container : CurrentData->Containers)
+		{
+			if (Container->IsUnpacked())
+			{
+				NumUnpacked++;
+			}
+			else
+			{
+				NumPacked++;
+			}
+
+			NumPendingDynamicActors += Container->GetNumPendingDynamicActors();
+		}
+	}
+
+	CSV_CUSTOM_STAT(Persistence, CommitsPerMinute, CommitsPerMinute, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, AvgCommitMs, static_cast<float>(AvgCommitMs), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, MaxCommitMs, static_cast<float>(LiveStats.MaxCommitMs), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, LastCommitKB, static_cast<float>(LiveStats.LastCommitBytes / 1024.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, QueuedJobs, NumQueuedJobs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, JobQueueWaitMs, QueueWaitMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, PackedContainers, NumPacked, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, UnpackedContainers, NumUnpacked, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, RegisteredComponents, RegisteredKeys.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, PendingDynamicActors, NumPendingDynamicActors, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Persistence, LoadLatencyMs, static_cast<float>(LiveStats.LastLoadLatencyMs), ECsvCustomStatOp::Set);
+
+	if (bShowOverlay)
+	{
+		// Use fixed keys so each line replaces itself every frame
+		const uint64 OverlayKey = reinterpret_cast<uint64>(this);
+
+		GEngine->AddOnScreenDebugMessage(OverlayKey + 0, 0.f, FColor::Cyan,
+			FString::Printf(TEXT("Persistence commits: %d/min, avg %.1f ms, max %.1f ms, last %.1f KB"),
+				CommitsPerMinute, AvgCommitMs, LiveStats.MaxCommitMs, LiveStats.LastCommitBytes / 1024.0));
+
+		GEngine->AddOnScreenDebugMessage(OverlayKey + 1, 0.f, FColor::Cyan,
+			FString::Printf(TEXT("Persistence jobs: %d queued, last wait %.1f ms, last load %.1f ms"),
+				NumQueuedJobs, QueueWaitMs, LiveStats.LastLoadLatencyMs));
+
+		GEngine->AddOnScreenDebugMessage(OverlayKey + 2, 0.f, FColor::Cyan,
+			FString::Printf(TEXT("Persistence containers: %d packed, %d unpacked, %d components registered, %d dynamic actors pending"),
+				NumPacked, NumUnpacked, RegisteredKeys.Num(), NumPendingDynamicActors));
+	}
+
+	return true;
+}
+
 void UPersistenceManager::QueueJob(FThreadJob* Job)
 {
 	check(IsInGameThread());
@@ -1762,9 +2451,13 @@ void UPersistenceManager::QueueJob(FThreadJob* Job)
 		OnBackgroundWorkBegin.Broadcast();
 	}
 
+	// This has to happen before the job is handed off, since the thread may start filling in the buffers right away
+	TrackJobBuffers(*Job);
+
 	{
 		FScopeLock Lock(&ThreadJobsLock);
 		Job->Manager = this;
+		Job->QueueTime = FPlatformTime::Seconds();
 		ThreadJobs.Add(Job);
 	}
 
@@ -1783,6 +2476,8 @@ void UPersistenceManager::FreeThreadJob(FThreadJob* Job)
 			ThisPtr->OnBackgroundWorkEnd.Broadcast();
 		}
 
+		ThisPtr->JobBufferBytes -= Job->TrackedBytes;
+
 		{
 			FScopeLock Lock(&ThisPtr->ThreadJobsLock);
 			delete Job;
@@ -1798,9 +2493,22 @@ void UPersistenceManager::FreeThreadJob(FThreadJob* Job)
 	}
 }
 
+void UPersistenceManager::TrackJobBuffers(FThreadJob& Job)
+{
+	int64 JobBytes = Job.WorldData.GetAllocatedSize() + Job.ProfileData.GetAllocatedSize();
+
+	if (Job.LoadedData.IsValid())
+	{
+		JobBytes += Job.LoadedData->GetAllocatedSize();
+	}
+
+	JobBufferBytes += JobBytes - Job.TrackedBytes;
+	Job.TrackedBytes = JobBytes;
+}
+
 uint32 UPersistenceManager::Run()
 {
-	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	LLM_SCOPE_BYTAG(Persistence);
 
 	while (!ThreadShouldStop)
 	{
@@ -1825,6 +2533,14 @@ uint32 UPersistenceManager::Run()
 			continue;
 		}
 
+		// Track how long jobs sit in the queue, since jobs are processed one at a time and a slow save system can back
+		// them up.
+		LastJobQueueWaitMs = static_cast<float>((FPlatformTime::Seconds() - Job->QueueTime) * 1000.0);
+		TRACE_COUNTER_SET(PersistenceJobQueueWait, LastJobQueueWaitMs.load());
+
+		// Look this up for each job, so the backend can be switched while the game is running
+		ISaveGameSystem* SaveSystem = GetSaveGameSystem();
+
 		// For debugging we support delaying the persistence jobs, to flush out any issues where game code isn't waiting
 		// for a job to finish.
 		const float JobDelay = CVarPersistenceJobDelay.GetValueOnAnyThread();
@@ -1842,14 +2558,80 @@ uint32 UPersistenceManager::Run()
 			{
 				bool Ret = true;
 
-				if (Job->WorldData.Num() > 0)
+#if USE_FILE_SAVEGAMESYSTEM
+				// The file save system can write the world and profile saves at the same time, and won't replace either
+				// of them unless both writes succeed
+				if (SaveSystem == &FFileSaveGameSystem::Get() && Job->WorldData.Num() > 0 && Job->ProfileData.Num() > 0)
 				{
 					const FString SlotName = GetSlotName(Job->Slot);
-					Ret = SaveSystem->SaveGame(false, *SlotName, UserIndex, Job->WorldData);
+
+					PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence SaveGames %s (%d bytes) and %s (%d bytes)"), *SlotName, Job->WorldData.Num(), SAVE_PROFILE_NAME, Job->ProfileData.Num());
+					Ret = FFileSaveGameSystem::Get().SaveGames({
+						FFileSaveGameSystem::FSaveRequest{ *SlotName, &Job->WorldData },
+						FFileSaveGameSystem::FSaveRequest{ SAVE_PROFILE_NAME, &Job->ProfileData } }, UserIndex);
+				}
+				else
+#endif
+				{
+					if (Job->WorldData.Num() > 0)
+					{
+						const FString SlotName = GetSlotName(Job->Slot);
+
+						PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence SaveGame %s (%d bytes)"), *SlotName, Job->WorldData.Num());
+						Ret = SaveSystem->SaveGame(false, *SlotName, UserIndex, Job->WorldData);
+					}
+
+					if (Ret && Job->ProfileData.Num() > 0)
+					{
+						PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence SaveGame %s (%d bytes)"), SAVE_PROFILE_NAME, Job->ProfileData.Num());
+						Ret = SaveSystem->SaveGame(false, SAVE_PROFILE_NAME, UserIndex, Job->ProfileData);
+					}
+				}
+
+				AsyncTask(ENamedThreads::GameThread, [Job, Ret]()
+				{
+					if (UPersistenceManager* ThisPtr = Job->Manager.Get())
+					{
+						ThisPtr->CommitSaveDone(*Job, Ret ? EPersistenceSaveResult::Success : EPersistenceSaveResult::Unknown);
+					}
+					FreeThreadJob(Job);
+				});
+			}
+			break;
+
+		case EJobType::CopySlot:
+			{
+				const FString SourceSlotName = GetSlotName(Job->SourceSlot);
+				const FString SlotName = GetSlotName(Job->Slot);
+
+				PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence CopySaveGame %s to %s"), *SourceSlotName, *SlotName);
+
+				bool Ret;
+
+#if USE_FILE_SAVEGAMESYSTEM
+				// The file save system can link or clone the file instead of writing it again
+				if (SaveSystem == &FFileSaveGameSystem::Get())
+				{
+					Ret = FFileSaveGameSystem::Get().CopySaveGame(*SourceSlotName, *SlotName);
+				}
+				else
+#endif
+				{
+					// Reading the save back in is still much cheaper than writing out all the save data again
+					Ret = SaveSystem->LoadGame(false, *SourceSlotName, UserIndex, Job->WorldData);
+
+					TrackJobBuffers(*Job);
+
+					if (Ret)
+					{
+						Ret = SaveSystem->SaveGame(false, *SlotName, UserIndex, Job->WorldData);
+					}
 				}
 
+				// The profile isn't tied to a slot, so it's always written out again
 				if (Ret && Job->ProfileData.Num() > 0)
 				{
+					PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence SaveGame %s (%d bytes)"), SAVE_PROFILE_NAME, Job->ProfileData.Num());
 					Ret = SaveSystem->SaveGame(false, SAVE_PROFILE_NAME, UserIndex, Job->ProfileData);
 				}
 
@@ -1869,6 +2651,8 @@ uint32 UPersistenceManager::Run()
 				const bool IsProfile = (Job->Type == EJobType::LoadProfile);
 				const FString SlotName = IsProfile ? SAVE_PROFILE_NAME : GetSlotName(Job->Slot);
 
+				PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence DoesSaveGameExist %s"), *SlotName);
+
 				EPersistenceHasResult Result;
 				DoesSaveGameExist(*SlotName, UserIndex, Result);
 
@@ -1890,6 +2674,8 @@ uint32 UPersistenceManager::Run()
 				const bool IsProfile = (Job->Type == EJobType::LoadProfile);
 				const FString SlotName = IsProfile ? SAVE_PROFILE_NAME : GetSlotName(Job->Slot);
 
+				PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence LoadSaveGame %s"), *SlotName);
+
 				EPersistenceHasResult ExistsResult;
 				DoesSaveGameExist(*SlotName, UserIndex, ExistsResult);
 
@@ -1909,9 +2695,9 @@ uint32 UPersistenceManager::Run()
 				}
 				else // Exists or Restored
 				{
-					TArray<uint8>& Data = IsProfile ? Job->ProfileData : Job->WorldData;
+					LoadSaveGame(*SlotName, UserIndex, Job->LoadedData, Result);
 
-					LoadSaveGame(*SlotName, UserIndex, Data, Result);
+					TrackJobBuffers(*Job);
 
 					if (Result == EPersistenceLoadResult::Success && ExistsResult == EPersistenceHasResult::Restored)
 					{
@@ -1929,8 +2715,7 @@ uint32 UPersistenceManager::Run()
 					{
 						if (Result == EPersistenceLoadResult::Success || Result == EPersistenceLoadResult::Restored)
 						{
-							const TArray<uint8>& Data = (Job->Type == EJobType::LoadProfile) ? Job->ProfileData : Job->WorldData;
-							if (ThisPtr->PreloadSave(*Job, Data))
+							if (ThisPtr->PreloadSave(*Job, Job->LoadedData->GetView()))
 							{
 								if (Job->AsyncLoad.IsValid())
 								{
@@ -1972,6 +2757,8 @@ uint32 UPersistenceManager::Run()
 				const bool IsProfile = (Job->Type == EJobType::DeleteProfile);
 				const FString SlotName = IsProfile ? SAVE_PROFILE_NAME : GetSlotName(Job->Slot);
 
+				PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence DeleteGame %s"), *SlotName);
+
 				if (SaveSystem->DeleteGame(false, *SlotName, UserIndex))
 				{
 					Result = true;
@@ -1999,6 +2786,8 @@ uint32 UPersistenceManager::Run()
 				const bool IsRestore = (Job->Type == EJobType::RestoreProfileBackup || Job->Type == EJobType::RestoreSlotBackup);
 				const FString SlotName = IsProfile ? SAVE_PROFILE_NAME : GetSlotName(Job->Slot);
 
+				PERSISTENCE_TRACE_SCOPE_TEXT(TEXT("Persistence %s %s"), IsRestore ? TEXT("RestoreBackup") : TEXT("DoesBackupExist"), *SlotName);
+
 				if (IsRestore)
 				{
 					Result = RestoreBackup(*SlotName);
@@ -2028,18 +2817,42 @@ uint32 UPersistenceManager::Run()
 	return 0;
 }
 
+ISaveGameSystem* UPersistenceManager::GetSaveGameSystem()
+{
+#if !UE_BUILD_SHIPPING
+	const FString Backend = CVarPersistenceBackend.GetValueOnAnyThread();
+
+	if (Backend == TEXT("Memory"))
+	{
+		return &FMemorySaveGameSystem::Get();
+	}
+
+	if (Backend == TEXT("Throttled"))
+	{
+		return &FThrottledSaveGameSystem::Get();
+	}
+#endif
+
+	return IPlatformFeaturesModule::Get().GetSaveGameSystem();
+}
+
 bool UPersistenceManager::DoesSaveGameExist(const FString& SlotName, const int32 UserIndex, EPersistenceHasResult& OutResult)
 {
 	ISaveGameSystem::ESaveExistsResult Exists;
 	bool bRestoredFromBackup = false;
 
-#if USE_WINDOWS_SAVEGAMESYSTEM
-	FWindowsSaveGameSystem& SaveSystem = FWindowsSaveGameSystem::Get();
-	Exists = SaveSystem.DoesSaveGameExistWithResult(*SlotName, UserIndex, bRestoredFromBackup);
-#else
-	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
-	Exists = SaveSystem->DoesSaveGameExistWithResult(*SlotName, UserIndex);
+	ISaveGameSystem* SaveSystem = GetSaveGameSystem();
+
+#if USE_FILE_SAVEGAMESYSTEM
+	if (SaveSystem == &FFileSaveGameSystem::Get())
+	{
+		Exists = FFileSaveGameSystem::Get().DoesSaveGameExistWithResult(*SlotName, UserIndex, bRestoredFromBackup);
+	}
+	else
 #endif
+	{
+		Exists = SaveSystem->DoesSaveGameExistWithResult(*SlotName, UserIndex);
+	}
 
 	switch (Exists)
 	{
@@ -2061,19 +2874,37 @@ bool UPersistenceManager::DoesSaveGameExist(const FString& SlotName, const int32
 	return false;
 }
 
-bool UPersistenceManager::LoadSaveGame(const FString& SlotName, const int32 UserIndex, TArray<uint8>& Data, EPersistenceLoadResult& OutResult)
+bool UPersistenceManager::LoadSaveGame(const FString& SlotName, const int32 UserIndex, TSharedPtr<FPersistenceSaveData>& OutData, EPersistenceLoadResult& OutResult)
 {
-	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	ISaveGameSystem* SaveSystem = GetSaveGameSystem();
 
 	bool bRestoredFromBackup = false;
 
 	do
 	{
-		if (SaveSystem->LoadGame(false, *SlotName, UserIndex, Data))
+		OutData.Reset();
+
+#if USE_FILE_SAVEGAMESYSTEM
+		// Mapping the save saves reading the whole thing up front and copying it around, and containers can keep
+		// pointing into it after it's loaded
+		if (SaveSystem == &FFileSaveGameSystem::Get() && CVarPersistenceMapSaves.GetValueOnAnyThread())
+		{
+			OutData = FFileSaveGameSystem::Get().MapSaveGame(*SlotName);
+		}
+#endif
+
+		TArray<uint8> Data;
+
+		if (!OutData.IsValid() && SaveSystem->LoadGame(false, *SlotName, UserIndex, Data))
+		{
+			OutData = MakeShared<FPersistenceSaveData>(MoveTemp(Data));
+		}
+
+		if (OutData.IsValid())
 		{
 			// We need to ensure the save data is readable. This will not check the objects in the save, only the
 			// header information and that the required save class is available.
-			if (VerifySaveIntegrity(Data, OutResult))
+			if (VerifySaveIntegrity(OutData->GetView(), OutResult))
 			{
 				OutResult = (bRestoredFromBackup) ? EPersistenceLoadResult::Restored : EPersistenceLoadResult::Success;
 			}
@@ -2100,29 +2931,33 @@ bool UPersistenceManager::LoadSaveGame(const FString& SlotName, const int32 User
 
 bool UPersistenceManager::DoesBackupExist(const FString& SlotName)
 {
-#if USE_WINDOWS_SAVEGAMESYSTEM
-	const FWindowsSaveGameSystem& SaveSystem = FWindowsSaveGameSystem::Get();
-	return SaveSystem.DoesBackupExist(*SlotName);
-#else
-	return false;
+#if USE_FILE_SAVEGAMESYSTEM
+	if (GetSaveGameSystem() == &FFileSaveGameSystem::Get())
+	{
+		return FFileSaveGameSystem::Get().DoesBackupExist(*SlotName);
+	}
 #endif
+
+	return false;
 }
 
 bool UPersistenceManager::RestoreBackup(const FString& SlotName)
 {
-#if USE_WINDOWS_SAVEGAMESYSTEM
-	const FWindowsSaveGameSystem& SaveSystem = FWindowsSaveGameSystem::Get();
-	return SaveSystem.RestoreBackup(*SlotName);
-#else
-	return false;
+#if USE_FILE_SAVEGAMESYSTEM
+	if (GetSaveGameSystem() == &FFileSaveGameSystem::Get())
+	{
+		return FFileSaveGameSystem::Get().RestoreBackup(*SlotName);
+	}
 #endif
+
+	return false;
 }
 
 #if WITH_EDITOR
 
 void UPersistenceManager::EditorInit()
 {
-	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	ISaveGameSystem* SaveSystem = GetSaveGameSystem();
 
 	if (!SaveSystem)
 	{
@@ -2152,7 +2987,7 @@ void UPersistenceManager::EditorInit()
 		if (Settings->AllowEditorSaving && SaveSystem->LoadGame(false, *GetSlotName(0), 0, ObjectBytes))
 		{
 			EPersistenceLoadResult Result;
-			CurrentData = Cast<USaveGameWorld>(ReadSave(ObjectBytes, Result));
+			CurrentData = Cast<USaveGameWorld>(ReadSave(MakeShared<FPersistenceSaveData>(MoveTemp(ObjectBytes)), Result));
 		}
 
 		if (CurrentData == nullptr)
@@ -2168,7 +3003,7 @@ void UPersistenceManager::EditorInit()
 			if (Settings->AllowEditorSaving && SaveSystem->LoadGame(false, SAVE_PROFILE_NAME, 0, ObjectBytes))
 			{
 				EPersistenceLoadResult Result;
-				UserProfile = Cast<USaveGameProfile>(ReadSave(ObjectBytes, Result));
+				UserProfile = Cast<USaveGameProfile>(ReadSave(MakeShared<FPersistenceSaveData>(MoveTemp(ObjectBytes)), Result));
 			}
 
 			if (UserProfile == nullptr)
@@ -5,21 +5,30 @@
 #include "CoreMinimal.h"
 #include "Engine/World.h"
 #include "Engine/DeveloperSettings.h"
+#include "HAL/LowLevelMemTracker.h"
 #include "HAL/Runnable.h"
+#include "Containers/Ticker.h"
+#include "Memory/MemoryView.h"
 #include "PersistenceTypes.h"
 #include "PersistenceManager.generated.h"
 
 DECLARE_STATS_GROUP(TEXT("PersistenceGunfire"), STATGROUP_Persistence, STATCAT_Advanced);
 
+LLM_DECLARE_TAG_API(Persistence, GUNFIRESAVESYSTEM_API);
+
 class UPersistenceComponent;
-class UPersistenceContainer;
+class FPersistenceCommitProfiler;
+class FPersistenceContainer;
+class FPersistenceSaveData;
 class USaveGame;
 class USaveGameWorld;
 class USaveGameProfile;
+class ISaveGameSystem;
 
 // A persistent actor reference. This will locate a reference from a persistent key, if the
-// actor is available. Please avoid using this when possible, as this is somewhat slow due
-// to iterating over all persistent components in the world.
+// actor is available. The resolved actor is cached along with the persistence manager's
+// registration generation, so repeated lookups are cheap and the cache is refreshed any
+// time persistent actors are registered or unregistered.
 //
 // WARNING: An actor reference will only persist if the owning actor AND the saved reference 
 // both have persistence components!
@@ -38,7 +47,10 @@ protected:
 	FPersistenceKey Key;
 
 	UPROPERTY(Transient)
-	TObjectPtr<AActor> CachedActor = nullptr;
+	TWeakObjectPtr<AActor> CachedActor = nullptr;
+
+	// The registration generation of the persistence manager when CachedActor was resolved
+	uint32 CachedGeneration = 0;
 };
 
 UCLASS(config = EditorPerProjectUserSettings)
@@ -72,6 +84,16 @@ public:
 	// with a particular save game slot, like unlocks.
 	UPROPERTY(config, EditAnywhere, Category = "Save System")
 	TSoftClassPtr<class USaveGameProfile> SaveProfileClass;
+
+	// If set, containers write each actor id once and refer to it by a small packed index everywhere else, instead of
+	// repeating the full guid. Containers written either way can always be loaded.
+	UPROPERTY(config, EditAnywhere, Category = "Save System")
+	bool CompactContainerIds = false;
+
+	// If set, persisted actor transforms are always stored with centimeter precision and a compressed rotation. This
+	// can also be enabled on individual persistence components.
+	UPROPERTY(config, EditAnywhere, Category = "Save System")
+	bool CompactTransforms = false;
 };
 
 DECLARE_DELEGATE_RetVal(int32, FGetBuildNumber);
@@ -143,10 +165,17 @@ public:
 	// When the commit is complete OnSaveGame will be called with the result.
 	void CommitSave(const FString& Reason, FCommitSaveComplete Callback = FCommitSaveComplete());
 
-	// Commits the current save data to a new slot, and sets that to be the current one.
+	// Commits the current save data to a new slot, and sets that to be the current one. If SaveSystem.CopyCommits is on
+	// and nothing has changed since the last successful commit, the world save from that commit is copied to the new
+	// slot instead of being written out again. The pre-save hooks still run and the profile is still written.
 	// When the commit is complete OnSaveGame will be called with the result.
 	void CommitSaveToSlot(int32 Slot, FCommitSaveComplete Callback = FCommitSaveComplete());
 
+	// Flags the save data as changed since the last commit. Components registering, writing, and being destroyed are
+	// tracked automatically, as is any world time passing, but game code that changes save data while the game is
+	// paused (from a menu, say) should call this before CommitSaveToSlot so the new slot isn't a copy of the last commit.
+	void MarkSaveDirty() { ++SaveStateGeneration; }
+
 	// Checks if the profile or a slot has a backup, and can restore it if there is one.
 	// These should only be needed when a save is flagged as corrupted, to attempt to
 	// restore the previous version.
@@ -183,6 +212,20 @@ public:
 	FPersistenceKey GetActorKey(AActor* Actor) const;
 	AActor* FindActorByKey(FPersistenceKey Key) const;
 
+	// Fills out a report of where the bytes in the current save are going. This reports on the save as of the last time
+	// each container was written, not the live state of loaded actors. Returns false if there's no current save.
+	bool BuildSizeReport(struct FPersistenceSizeReport& Report);
+
+	// Decodes a save (as it's written to storage) into a size report. Returns false if the save couldn't be read.
+	static bool DescribeSave(const TArray<uint8>& SaveBlob, struct FPersistenceSizeReport& Report);
+
+	// Writes a breakdown of the memory currently held by the save system to the output device
+	void DumpMemoryReport(FOutputDevice& Ar) const;
+
+	// Incremented every time a persistence component is registered or unregistered, so cached lookups can tell if
+	// they're stale.
+	uint32 GetRegistrationGeneration() const { return RegistrationGeneration; }
+
 	bool IsSaving() const { return NumSavesPending > 0; }
 	bool HasPendingSave() const { return NumSavesPending > 1; }
 
@@ -206,7 +249,7 @@ public:
 	void Unregister(UPersistenceComponent* pComponent, ULevel* OverrideLevel = nullptr);
 
 	// Returns the container for a given persistence component (if it exists)
-	UPersistenceContainer* GetContainer(const UPersistenceComponent* Component);
+	FPersistenceContainer* GetContainer(const UPersistenceComponent* Component);
 
 	// Marks a component as destroyed
 	void SetComponentDestroyed(UPersistenceComponent* Component);
@@ -237,6 +280,37 @@ public:
 	// Adds level offset to the transform for the specified level
 	void AddLevelOffset(ULevel* Level, FTransform& Transform);
 
+#if !UE_BUILD_SHIPPING
+	//////////////////////////////////////////////////////////////////////////////////////
+	//
+	// Test access, for tools like the benchmark commandlet that drive the manager directly instead of going through
+	// save slots and the persistence thread. Game code shouldn't use these.
+	//
+
+	// Replaces the current save, or creates a new empty one if SaveGame is null. No slot is selected afterwards, so
+	// commits won't write anything to storage.
+	void SetCurrentSaveForTesting(USaveGameWorld* SaveGame);
+
+	// Sends components registered from Level to ContainerKey, the same as if Level had been loaded for that container
+	void SetLevelContainerForTesting(ULevel* Level, const FName& ContainerKey) { LoadedLevels.Add(Level, ContainerKey); }
+
+	// Writes every container that has registered components, the same as a commit does
+	void WriteContainersForTesting();
+
+	FPersistenceContainer* FindContainerForTesting(const FName& Name) const { return GetContainer(Name, false); }
+
+	// Converts a save to and from the format it's stored in
+	void WriteSaveForTesting(USaveGame* SaveGame, TArray<uint8>& SaveBlob) { WriteSave(SaveGame, SaveBlob); }
+	USaveGame* ReadSaveForTesting(const TSharedRef<const FPersistenceSaveData>& SaveData, EPersistenceLoadResult& Result) { return ReadSave(SaveData, Result); }
+
+	// Reads and validates the header of a save, which includes checksumming the whole thing
+	static EPersistenceLoadResult ReadSaveHeaderForTesting(FMemoryView SaveBlob);
+
+	// Replaces everything after the header of a save with Payload, keeping the rest of the header. Returns false if the
+	// save's header couldn't be read.
+	static bool ReplaceSavePayloadForTesting(TArray<uint8>& SaveBlob, TConstArrayView<uint8> Payload);
+#endif
+
 	//////////////////////////////////////////////////////////////////////////////////////
 	//
 	// Events
@@ -289,6 +363,7 @@ protected:
 		DeleteSlot,
 		DeleteProfile,
 		Commit,
+		CopySlot,
 		HasSlotBackup,
 		HasProfileBackup,
 		RestoreSlotBackup,
@@ -314,34 +389,75 @@ protected:
 
 		// Validates and prepares the save for reading. If this returns success the archive passed in will be ready for
 		// reading the save data from.
-		EPersistenceLoadResult Read(FArchive& Archive, const TArray<uint8>& SaveBlob);
+		EPersistenceLoadResult Read(FArchive& Archive, FMemoryView SaveBlob);
 
 	private:
 		int32 GetChecksumDataStartOffset() const;
 	};
 
+	// What a world save was written from, to tell if the current save data still matches it
+	struct FCommittedWorldSave
+	{
+		int32 Slot = -1;
+		uint32 SaveStateGeneration = 0;
+		uint32 RegistrationGeneration = 0;
+		double WorldTime = 0.0;
+		TWeakObjectPtr<USaveGameWorld> Data;
+
+		// Hashes of the world save's own properties (not its containers) and of the profile save, to catch changes the
+		// pre-commit hooks make. These are only filled in when SaveSystem.CopyCommits is on.
+		uint32 PropertiesHash = 0;
+		uint32 ProfileHash = 0;
+	};
+
 	struct FThreadJob
 	{
 		TWeakObjectPtr<UPersistenceManager> Manager;
 		EJobType Type = EJobType::Uninitialized;
 		TArray<uint8> WorldData;
 		TArray<uint8> ProfileData;
+
+		// The save read in by a load job. This may be a mapping of the save file instead of a copy of it.
+		TSharedPtr<FPersistenceSaveData> LoadedData;
+
 		int32 Slot = -1;
+
+		// For copy jobs, the slot being copied to Slot
+		int32 SourceSlot = -1;
+
+		// For commit and copy jobs, what the world save in Slot was written from
+		FCommittedWorldSave CommittedWorld;
+
 		FLoadSaveComplete LoadCallback;
 		FHasSaveComplete HasCallback;
 		FDeleteSaveComplete DeleteCallback;
 		FCommitSaveComplete SaveCallback;
 		TSharedPtr<struct FStreamableHandle> AsyncLoad;
+
+		// When the job was added to the thread queue, for tracking how long it waited
+		double QueueTime = 0.0;
+
+		// How much of the save data buffers has been added to JobBufferBytes
+		int64 TrackedBytes = 0;
 	};
 
+	// Updates JobBufferBytes with any change in the size of a job's save data buffers
+	void TrackJobBuffers(FThreadJob& Job);
+
 	void WriteSave(USaveGame* SaveGame, TArray<uint8>& SaveBlob);
-	bool PreloadSave(FThreadJob& Job, const TArray<uint8>& SaveBlob);
-	USaveGame* ReadSave(const TArray<uint8>& SaveBlob, EPersistenceLoadResult& Result);
-	static bool VerifySaveIntegrity(const TArray<uint8>& SaveBlob, EPersistenceLoadResult& Result);
+	bool PreloadSave(FThreadJob& Job, FMemoryView SaveBlob);
+	USaveGame* ReadSave(const TSharedRef<const FPersistenceSaveData>& SaveData, EPersistenceLoadResult& Result);
+	static bool VerifySaveIntegrity(FMemoryView SaveBlob, EPersistenceLoadResult& Result);
 	void OnSaveClassesLoaded(FThreadJob* Job);
 
+	// The save system all saves are read from and written to. This is the platform's save system, unless
+	// SaveSystem.Backend selects one of the backends for testing.
+	static ISaveGameSystem* GetSaveGameSystem();
+
 	static bool DoesSaveGameExist(const FString& SlotName, const int32 UserIndex, EPersistenceHasResult& OutResult);
-	static bool LoadSaveGame(const FString& SlotName, const int32 UserIndex, TArray<uint8>& Data, EPersistenceLoadResult& OutResult);
+	// Reads in a save, restoring a backup if it's corrupt. With the file save system the save is mapped instead of read
+	// if SaveSystem.MapSaves is on.
+	static bool LoadSaveGame(const FString& SlotName, const int32 UserIndex, TSharedPtr<FPersistenceSaveData>& OutData, EPersistenceLoadResult& OutResult);
 	static bool DoesBackupExist(const FString& SlotName);
 	static bool RestoreBackup(const FString& SlotName);
 
@@ -359,14 +475,35 @@ protected:
 	void ReadSaveDone(const FThreadJob& Job, EPersistenceLoadResult Result);
 	void HasSaveDone(const FThreadJob& Job, EPersistenceHasResult Result);
 	void CommitSaveDone(const FThreadJob& Job, EPersistenceSaveResult Result);
+
+	// Does the work for CommitSave. If bTryCopyWorld is set and the world save from the last successful commit can be
+	// copied to the current slot, the containers and world save aren't written out.
+	void CommitSaveInternal(const FString& Reason, FCommitSaveComplete Callback, bool bTryCopyWorld);
+
+	// Has the registered components write their containers, then writes the world save into the job
+	void WriteCurrentWorld(FThreadJob& Job, FPersistenceCommitProfiler& Profiler);
+
+	// Whether the world save from the last successful commit still matches the current save data and the profile being
+	// committed, so it can be copied to the current slot instead of writing everything out again. This is checked after
+	// the pre-commit hooks run, so anything they change is counted.
+	bool CanCopyLastCommit(uint32 ProfileHash) const;
 	void DeleteSaveDone(const FThreadJob& Job, bool Result);
 	void BackupOperationDone(const FThreadJob& Job, bool Result);
 
-	UPersistenceContainer* GetContainer(const FName& Name, bool CreateIfMissing) const;
+	FPersistenceContainer* GetContainer(const FName& Name, bool CreateIfMissing) const;
 	inline const FName& GetContainerKey(const UPersistenceComponent* Component) const;
 	bool DeleteContainer(const FName& ContainerName, bool BlockLoadedLevel);
 	void PackContainer(const FName& Name);
 
+	// Swap removes a component from a registered actors list using its cached index. Returns the number removed.
+	static int32 RemoveRegisteredComponent(TArray<TWeakObjectPtr<UPersistenceComponent>>& Components, UPersistenceComponent* pComponent);
+
+	// Removes the registered actors list for a container, resetting the cached index on all the components in it.
+	void ClearRegisteredComponents(const FName& ContainerKey);
+
+	// Removes the key lookup entry for a component, if it's the one registered under that key.
+	void RemoveRegisteredKey(const FName& ContainerKey, UPersistenceComponent* pComponent);
+
 #if !UE_BUILD_SHIPPING
 	static FName GetQualifiedContainerKey(const FName& ContainerKey);
 #endif
@@ -388,6 +525,12 @@ protected:
 
 	void ProcessCachedLoads();
 
+	// Adds a level to our loaded list, returning its container if it has one that needs to be unpacked
+	FPersistenceContainer* AddLoadedLevel(ULevel* Level);
+
+	// Updates the live counters for the CSV profiler and the SaveSystem.Debug 2 overlay
+	bool TickLiveStats(float DeltaTime);
+
 	void QueueJob(FThreadJob* Job);
 	static void FreeThreadJob(FThreadJob* Job);
 	virtual uint32 Run() override;
@@ -397,6 +540,12 @@ protected:
 
 	int32 NumSavesPending = 0;
 
+	// Incremented by MarkSaveDirty
+	uint32 SaveStateGeneration = 1;
+
+	// The world save written by the last successful commit, if there was one
+	FCommittedWorldSave LastCommittedWorld;
+
 	// The current save data. This may include uncommitted changes.
 	UPROPERTY(Transient)
 	TObjectPtr<USaveGameWorld> CurrentData = nullptr;
@@ -412,6 +561,11 @@ protected:
 	// unregister themselves before destructing, so we should never actually have a null pointer in here.
 	TMap<FName, TArray<TWeakObjectPtr<UPersistenceComponent>>> RegisteredActors;
 
+	// All the currently active persistent objects, indexed by their key for quick lookups.
+	TMap<FPersistenceKey, TWeakObjectPtr<UPersistenceComponent>> RegisteredKeys;
+
+	uint32 RegistrationGeneration = 1;
+
 	bool IsCachingUnloads = false;
 
 	UPROPERTY(Transient)
@@ -442,6 +596,33 @@ protected:
 	bool				HasRunningThreadJob = false;
 	bool				ThreadShouldStop = false;
 
+	// Memory held by the save data buffers of jobs that haven't been freed yet. Updated from the persistence thread.
+	std::atomic<int64>	JobBufferBytes = 0;
+
+	// Memory held by containers and job buffers at the end of the last commit, when it's typically at its highest
+	int64 LastCommitPeakBytes = 0;
+
+	// How long the last job the thread picked up waited in the queue
+	std::atomic<float>	LastJobQueueWaitMs = 0.f;
+
+	// Running totals for the live counters
+	struct FLiveStats
+	{
+		// When each commit in the last minute happened
+		TArray<double> RecentCommitTimes;
+
+		int32 NumCommits = 0;
+		double TotalCommitMs = 0.0;
+		double MaxCommitMs = 0.0;
+		int64 LastCommitBytes = 0;
+
+		// Time from queueing the last load job to its results arriving on the game thread
+		double LastLoadLatencyMs = 0.0;
+	};
+
+	FLiveStats LiveStats;
+	FTSTicker::FDelegateHandle LiveStatsTickerHandle;
+
 	struct FLevelOffset
 	{
 		TWeakObjectPtr<ULevelStreaming> Level;
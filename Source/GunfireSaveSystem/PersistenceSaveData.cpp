@@ -0,0 +1,44 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceSaveData.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+
+FPersistenceSaveData::FPersistenceSaveData()
+{
+}
+
+FPersistenceSaveData::FPersistenceSaveData(TArray<uint8>&& InBuffer)
+	: Buffer(MoveTemp(InBuffer))
+{
+	View = MakeMemoryView(Buffer);
+}
+
+FPersistenceSaveData::~FPersistenceSaveData()
+{
+}
+
+TSharedPtr<FPersistenceSaveData> FPersistenceSaveData::MapFile(const TCHAR* Path)
+{
+	TUniquePtr<IMappedFileHandle> Handle(IPlatformFile::GetPlatformPhysical().OpenMapped(Path));
+
+	if (!Handle.IsValid() || Handle->GetFileSize() <= 0)
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion());
+
+	if (!Region.IsValid())
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FPersistenceSaveData> SaveData = MakeShared<FPersistenceSaveData>();
+	SaveData->View = MakeMemoryView(Region->GetMappedPtr(), Region->GetMappedSize());
+	SaveData->MappedHandle = MoveTemp(Handle);
+	SaveData->MappedRegion = MoveTemp(Region);
+
+	return SaveData;
+}
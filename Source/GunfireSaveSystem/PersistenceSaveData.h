@@ -0,0 +1,45 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Memory/MemoryView.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+//
+// The bytes of a save that was read in. This is either a buffer the save was loaded into, or a read only mapping of the
+// save file, in which case pages are only read from storage when they're touched. It's shared, so the containers in a
+// world save can point into it instead of each copying out their own data.
+//
+class GUNFIRESAVESYSTEM_API FPersistenceSaveData
+{
+public:
+	FPersistenceSaveData();
+	explicit FPersistenceSaveData(TArray<uint8>&& InBuffer);
+	~FPersistenceSaveData();
+
+	FPersistenceSaveData(const FPersistenceSaveData&) = delete;
+	FPersistenceSaveData& operator=(const FPersistenceSaveData&) = delete;
+
+	// Maps a file for reading. Returns null if the file doesn't exist, is empty, or the platform can't map it.
+	static TSharedPtr<FPersistenceSaveData> MapFile(const TCHAR* Path);
+
+	FMemoryView GetView() const { return View; }
+	int64 Num() const { return static_cast<int64>(View.GetSize()); }
+
+	bool IsMapped() const { return MappedRegion.IsValid(); }
+
+	// Heap memory held for the data. Mapped files are backed by the page cache, so they don't count.
+	SIZE_T GetAllocatedSize() const { return Buffer.GetAllocatedSize(); }
+
+private:
+	TArray<uint8> Buffer;
+
+	// The region has to be released before the handle, so it's declared after it
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	FMemoryView View;
+};
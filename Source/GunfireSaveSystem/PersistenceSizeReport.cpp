@@ -0,0 +1,109 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceSizeReport.h"
+
+#include "Misc/OutputDevice.h"
+
+const TCHAR* FPersistenceSizeReport::GetCategoryName(ECategory Category)
+{
+	switch (Category)
+	{
+	case ECategory::Container:		return TEXT("Container");
+	case ECategory::ActorClass:		return TEXT("ActorClass");
+	case ECategory::Component:		return TEXT("Component");
+	case ECategory::SubobjectClass:	return TEXT("SubobjectClass");
+	case ECategory::Property:		return TEXT("Property");
+	case ECategory::Overhead:		return TEXT("Overhead");
+	default:						return TEXT("Unknown");
+	}
+}
+
+void FPersistenceSizeReport::Add(ECategory Category, const FString& Name, int64 Bytes, int32 Count)
+{
+	if (ensure(Category < ECategory::Num))
+	{
+		FEntry& Entry = Entries[(int32)Category].FindOrAdd(Name);
+		Entry.Bytes += Bytes;
+		Entry.Count += Count;
+	}
+}
+
+void FPersistenceSizeReport::Reset()
+{
+	for (TMap<FString, FEntry>& CategoryEntries : Entries)
+	{
+		CategoryEntries.Reset();
+	}
+
+	SaveSize = 0;
+}
+
+TArray<TPair<FString, FPersistenceSizeReport::FEntry>> FPersistenceSizeReport::GetSortedEntries(ECategory Category) const
+{
+	TArray<TPair<FString, FEntry>> Sorted = Entries[(int32)Category].Array();
+
+	Sorted.Sort([](const TPair<FString, FEntry>& A, const TPair<FString, FEntry>& B)
+	{
+		if (A.Value.Bytes != B.Value.Bytes)
+		{
+			return A.Value.Bytes > B.Value.Bytes;
+		}
+
+		return A.Key < B.Key;
+	});
+
+	return Sorted;
+}
+
+void FPersistenceSizeReport::Dump(FOutputDevice& Ar, int32 MaxEntries) const
+{
+	Ar.Logf(TEXT("Save size report: %lld bytes"), SaveSize);
+
+	for (int32 CategoryIndex = 0; CategoryIndex < (int32)ECategory::Num; CategoryIndex++)
+	{
+		const ECategory Category = (ECategory)CategoryIndex;
+		const TArray<TPair<FString, FEntry>> Sorted = GetSortedEntries(Category);
+
+		if (Sorted.Num() == 0)
+		{
+			continue;
+		}
+
+		int64 CategoryBytes = 0;
+		for (const TPair<FString, FEntry>& Entry : Sorted)
+		{
+			CategoryBytes += Entry.Value.Bytes;
+		}
+
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("%s (%d entries, %lld bytes)"), GetCategoryName(Category), Sorted.Num(), CategoryBytes);
+
+		const int32 NumToWrite = (MaxEntries > 0) ? FMath::Min(MaxEntries, Sorted.Num()) : Sorted.Num();
+
+		for (int32 i = 0; i < NumToWrite; i++)
+		{
+			const TPair<FString, FEntry>& Entry = Sorted[i];
+			const double Percent = (SaveSize > 0) ? (100.0 * Entry.Value.Bytes / SaveSize) : 0.0;
+
+			Ar.Logf(TEXT("  %10lld %5.1f%% %6d  %s"), Entry.Value.Bytes, Percent, Entry.Value.Count, *Entry.Key);
+		}
+	}
+}
+
+FString FPersistenceSizeReport::ToCsv() const
+{
+	FString Csv = TEXT("Category,Name,Count,Bytes\n");
+
+	for (int32 CategoryIndex = 0; CategoryIndex < (int32)ECategory::Num; CategoryIndex++)
+	{
+		const ECategory Category = (ECategory)CategoryIndex;
+
+		for (const TPair<FString, FEntry>& Entry : GetSortedEntries(Category))
+		{
+			// Names are object and property paths, which can't contain quotes, but may contain commas
+			Csv += FString::Printf(TEXT("%s,\"%s\",%d,%lld\n"), GetCategoryName(Category), *Entry.Key, Entry.Value.Count, Entry.Value.Bytes);
+		}
+	}
+
+	return Csv;
+}
@@ -0,0 +1,59 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//
+// A breakdown of where the bytes in a save are going, built by UPersistenceManager::DescribeSave. Each category is a
+// separate view of the same data, so the totals overlap (a property's bytes are also counted against its actor class and
+// container). Anything that isn't object data, like headers, indices and name tables, is reported as overhead.
+//
+struct GUNFIRESAVESYSTEM_API FPersistenceSizeReport
+{
+public:
+	enum class ECategory : uint8
+	{
+		Container,
+		ActorClass,
+		Component,
+		SubobjectClass,
+		Property,
+		Overhead,
+
+		Num
+	};
+
+	static const TCHAR* GetCategoryName(ECategory Category);
+
+	void Add(ECategory Category, const FString& Name, int64 Bytes, int32 Count = 1);
+
+	void Reset();
+
+	// The total size of the save this report was built from
+	int64 GetSaveSize() const { return SaveSize; }
+	void SetSaveSize(int64 InSaveSize) { SaveSize = InSaveSize; }
+
+	// Writes the largest entries in each category to the output device. If MaxEntries is zero everything is written.
+	void Dump(FOutputDevice& Ar, int32 MaxEntries = 20) const;
+
+	// Returns the full report as CSV, sorted by category and then by size
+	FString ToCsv() const;
+
+	// The class of placed actors isn't stored in the save, so if this is set it'll be called to look it up. If it isn't
+	// set, or returns an empty string, placed actors are reported under a generic name.
+	TFunction<FString(const FName& ContainerKey, const FGuid& ActorId)> ResolveActorClass;
+
+private:
+	struct FEntry
+	{
+		int64 Bytes = 0;
+		int32 Count = 0;
+	};
+
+	TArray<TPair<FString, FEntry>> GetSortedEntries(ECategory Category) const;
+
+	TMap<FString, FEntry> Entries[(int32)ECategory::Num];
+
+	int64 SaveSize = 0;
+};
@@ -0,0 +1,7 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceTrace.h"
+
+#if PERSISTENCE_TRACE_ENABLED
+UE_TRACE_CHANNEL_DEFINE(PersistenceChannel);
+#endif
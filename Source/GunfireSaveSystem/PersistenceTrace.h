@@ -0,0 +1,41 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+//
+// Unreal Insights instrumentation for the persistence pipeline. Everything is on its own channel, so it can be captured
+// without the noise (or cost) of the full cpu channel. Enable with -trace=persistence. This is compiled out of shipping
+// builds, so use a test build to capture it on hardware that's close to what players have.
+//
+#if CPUPROFILERTRACE_ENABLED && !UE_BUILD_SHIPPING
+#define PERSISTENCE_TRACE_ENABLED 1
+#else
+#define PERSISTENCE_TRACE_ENABLED 0
+#endif
+
+#if PERSISTENCE_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(PersistenceChannel, GUNFIRESAVESYSTEM_API);
+
+// A span with a fixed name
+#define PERSISTENCE_TRACE_SCOPE(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, PersistenceChannel)
+
+// A span with a name formatted at runtime, for tagging it with a slot, container key or size. The string is only
+// formatted when the channel is enabled.
+#define PERSISTENCE_TRACE_SCOPE_TEXT(Format, ...) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL( \
+		UE_TRACE_CHANNELEXPR_IS_ENABLED(PersistenceChannel) ? *FString::Printf(Format, ##__VA_ARGS__) : TEXT("Persistence"), \
+		PersistenceChannel)
+
+#else
+
+#define PERSISTENCE_TRACE_SCOPE(Name)
+#define PERSISTENCE_TRACE_SCOPE_TEXT(Format, ...)
+
+#endif
@@ -73,12 +73,26 @@ struct GUNFIRESAVESYSTEM_API FPersistenceKey
 	UPROPERTY(SaveGame)
 	FGuid PersistentId;
 
+	FPersistenceKey() = default;
+
+	FPersistenceKey(const FName& InContainerKey, const FGuid& InPersistentId)
+		: ContainerKey(InContainerKey)
+		, PersistentId(InPersistentId)
+	{}
+
 	bool Equals(const FPersistenceKey& Other) const
 	{
 		return (ContainerKey == Other.ContainerKey) && (PersistentId == Other.PersistentId);
 	}
 
+	bool operator==(const FPersistenceKey& Other) const { return Equals(Other); }
+
 	bool IsValid() const { return PersistentId.IsValid(); }
+
+	friend uint32 GetTypeHash(const FPersistenceKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.ContainerKey), GetTypeHash(Key.PersistentId));
+	}
 };
 
 // The default property saving code is pretty dumb and will write an array of uint8's one byte at a time with a ton of
@@ -2,10 +2,96 @@
 
 #include "PersistenceUtils.h"
 
+#include "PersistenceManager.h"
+
 #include "GameFramework/Actor.h"
 
 DEFINE_LOG_CATEGORY(LogGunfireSaveSystem);
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Transforms Written"), STAT_PersistenceGunfire_TransformsWritten, STATGROUP_Persistence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Quantized Transforms Written"), STAT_PersistenceGunfire_QuantizedTransformsWritten, STATGROUP_Persistence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Transform Bytes Written"), STAT_PersistenceGunfire_TransformBytesWritten, STATGROUP_Persistence);
+
+// Number of bits for each of the three smallest quaternion components
+#define QUAT_COMPONENT_BITS 20
+#define QUAT_COMPONENT_MAX ((1 << QUAT_COMPONENT_BITS) - 1)
+
+namespace PersistenceUtilsPrivate
+{
+	// Zigzag encode a signed value, so small negative values stay small when packed
+	uint32 ZigZagEncode(int32 Value)
+	{
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	int32 ZigZagDecode(uint32 Value)
+	{
+		return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+	}
+
+	uint64 PackQuat(FQuat Quat)
+	{
+		Quat.Normalize();
+
+		const double Components[4] = { Quat.X, Quat.Y, Quat.Z, Quat.W };
+
+		// Find the largest component. We don't need to store it, since it can be derived from the other three.
+		int32 LargestIndex = 0;
+		for (int32 i = 1; i < 4; i++)
+		{
+			if (FMath::Abs(Components[i]) > FMath::Abs(Components[LargestIndex]))
+			{
+				LargestIndex = i;
+			}
+		}
+
+		// q and -q are the same rotation, so flip the sign if needed to make the largest component positive.
+		const double Sign = Components[LargestIndex] < 0.0 ? -1.0 : 1.0;
+
+		uint64 Packed = static_cast<uint64>(LargestIndex);
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			if (i != LargestIndex)
+			{
+				// The remaining components are always in the range [-1/sqrt(2), 1/sqrt(2)]
+				const double Normalized = (Components[i] * Sign * UE_SQRT_2 + 1.0) * 0.5;
+				const uint64 Quantized = static_cast<uint64>(FMath::Clamp(FMath::RoundToInt64(Normalized * QUAT_COMPONENT_MAX), 0LL, static_cast<int64>(QUAT_COMPONENT_MAX)));
+
+				Packed = (Packed << QUAT_COMPONENT_BITS) | Quantized;
+			}
+		}
+
+		return Packed;
+	}
+
+	FQuat UnpackQuat(uint64 Packed)
+	{
+		double Components[4];
+		double SumSquares = 0.0;
+
+		const int32 LargestIndex = static_cast<int32>((Packed >> (QUAT_COMPONENT_BITS * 3)) & 3);
+
+		for (int32 i = 3; i >= 0; i--)
+		{
+			if (i != LargestIndex)
+			{
+				const double Quantized = static_cast<double>(Packed & QUAT_COMPONENT_MAX);
+				Packed >>= QUAT_COMPONENT_BITS;
+
+				Components[i] = ((Quantized / QUAT_COMPONENT_MAX) * 2.0 - 1.0) / UE_SQRT_2;
+				SumSquares += Components[i] * Components[i];
+			}
+		}
+
+		Components[LargestIndex] = FMath::Sqrt(FMath::Max(0.0, 1.0 - SumSquares));
+
+		FQuat Quat(Components[0], Components[1], Components[2], Components[3]);
+		Quat.Normalize();
+		return Quat;
+	}
+}
+
 bool UPersistenceUtils::HasModifiedSaveProperties(AActor* Actor)
 {
 	if (Actor == nullptr)
@@ -68,3 +154,76 @@ bool UPersistenceUtils::HasModifiedSaveProperties(UClass* Class, UObject* Obj)
 
 	return HasNonDefault;
 }
+
+EPersistenceTransformEncoding UPersistenceUtils::GetTransformEncoding(const FTransform& Transform, bool bCompact)
+{
+	if (bCompact)
+	{
+		// Positions are stored as 32 bit centimeters, so anything outside that range needs the full encoding.
+		const FVector Location = Transform.GetLocation();
+		if (Location.GetAbsMax() < static_cast<double>(MAX_int32))
+		{
+			return Transform.GetScale3D().Equals(FVector::OneVector, UE_KINDA_SMALL_NUMBER) ?
+				EPersistenceTransformEncoding::QuantizedUnitScale :
+				EPersistenceTransformEncoding::Quantized;
+		}
+	}
+
+	return EPersistenceTransformEncoding::Full;
+}
+
+void UPersistenceUtils::SerializeTransform(FArchive& Ar, FTransform& Transform, EPersistenceTransformEncoding Encoding)
+{
+	using namespace PersistenceUtilsPrivate;
+
+	const int64 StartPos = Ar.Tell();
+
+	if (Encoding == EPersistenceTransformEncoding::Full)
+	{
+		Ar << Transform;
+	}
+	else if (Encoding == EPersistenceTransformEncoding::Quantized || Encoding == EPersistenceTransformEncoding::QuantizedUnitScale)
+	{
+		// Location, rounded to the nearest centimeter
+		FVector Location = Transform.GetLocation();
+		uint32 PackedLocation[3];
+
+		for (int32 i = 0; i < 3; i++)
+		{
+			PackedLocation[i] = ZigZagEncode(static_cast<int32>(FMath::RoundToInt64(Location[i])));
+			Ar.SerializeIntPacked(PackedLocation[i]);
+			Location[i] = static_cast<double>(ZigZagDecode(PackedLocation[i]));
+		}
+
+		// Rotation, as the smallest three components of the quaternion
+		uint64 PackedRotation = PackQuat(Transform.GetRotation());
+		Ar << PackedRotation;
+
+		// Scale, if it isn't one
+		FVector3f Scale(Transform.GetScale3D());
+		if (Encoding == EPersistenceTransformEncoding::Quantized)
+		{
+			Ar << Scale;
+		}
+		else
+		{
+			Scale = FVector3f::OneVector;
+		}
+
+		if (Ar.IsLoading())
+		{
+			Transform = FTransform(UnpackQuat(PackedRotation), Location, FVector(Scale));
+		}
+	}
+
+	if (Ar.IsSaving())
+	{
+		INC_DWORD_STAT(STAT_PersistenceGunfire_TransformsWritten);
+		INC_DWORD_STAT_BY(STAT_PersistenceGunfire_TransformBytesWritten, static_cast<uint32>(Ar.Tell() - StartPos));
+
+		if (Encoding != EPersistenceTransformEncoding::Full)
+		{
+			INC_DWORD_STAT(STAT_PersistenceGunfire_QuantizedTransformsWritten);
+		}
+	}
+}
@@ -6,12 +6,35 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(LogGunfireSaveSystem, Log, All);
 
+// How a transform is written to a persistence container
+enum class EPersistenceTransformEncoding : uint8
+{
+	// No transform is stored
+	None,
+
+	// The full precision transform
+	Full,
+
+	// Position to the nearest centimeter, rotation as a 64 bit smallest three quaternion, and full precision scale
+	Quantized,
+
+	// Same as Quantized, but the scale is omitted since it's one
+	QuantizedUnitScale,
+};
+
 class UPersistenceUtils
 {
 public:
 	// Returns true if this actor has SaveGame flagged properties that differ from the defaults (changed on the instance)
 	static bool HasModifiedSaveProperties(class AActor* Actor);
 
+	// Returns the encoding to use for a transform. If compact encoding isn't requested, or the transform can't be
+	// represented with it, the full encoding is used.
+	static EPersistenceTransformEncoding GetTransformEncoding(const FTransform& Transform, bool bCompact);
+
+	// Reads or writes a transform with the specified encoding. The encoding itself isn't serialized.
+	static void SerializeTransform(FArchive& Ar, FTransform& Transform, EPersistenceTransformEncoding Encoding);
+
 private:
 	static bool HasModifiedSaveProperties(UClass* Class, UObject* Obj);
 };
@@ -1,10 +1,18 @@
 // Copyright Gunfire Games, LLC. All Rights Reserved.
 
 #include "SaveGameArchive.h"
+#include "PersistenceCommitProfiler.h"
+#include "PersistenceManager.h"
+#include "PersistenceSizeReport.h"
 #include "PersistenceUtils.h"
 
 #include "GameFramework/Actor.h"
 #include "UObject/Package.h"
+#include "UObject/PropertyTag.h"
+#include "UObject/UObjectHash.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Objects Created On Load"), STAT_PersistenceGunfire_ObjectsCreated, STATGROUP_Persistence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Objects Reused On Load"), STAT_PersistenceGunfire_ObjectsReused, STATGROUP_Persistence);
 
 static const int32 GUNFIRE_SAVEGAME_ARCHIVE_VERSION = 1;
 
@@ -102,6 +110,30 @@ FSaveGameArchive::FSaveGameArchive(FArchive& InInnerArchive, FNameCache* SharedN
 	}
 }
 
+FSaveGameArchive::FSaveGameArchive(FArchive& InInnerArchive, FNameCache& SharedNameCache, int32 SharedVersion)
+	: FObjectAndNameAsStringProxyArchive(InInnerArchive, true)
+	, Version(SharedVersion)
+	, NameCache(SharedNameCache)
+{
+	SetIsPersistent(true);
+	ArIsSaveGame = true;
+
+	InitialOffset = static_cast<int32>(Tell());
+}
+
+void FSaveGameArchive::Reset()
+{
+	Objects.Reset();
+	ObjectsToSerialize.Reset();
+
+	InitialOffset = static_cast<int32>(Tell());
+}
+
+int32 FSaveGameArchive::GetLatestVersion()
+{
+	return GUNFIRE_SAVEGAME_ARCHIVE_VERSION;
+}
+
 FArchive& FSaveGameArchive::operator<<(UObject*& Obj)
 {
 	int32 ObjectIndex = -1;
@@ -140,6 +172,9 @@ FArchive& FSaveGameArchive::operator<<(UObject*& Obj)
 
 uint32 FSaveGameArchive::WriteObjectAndLength(UObject* Object)
 {
+	FPersistenceCommitProfiler* Profiler = FPersistenceCommitProfiler::GetActive();
+	const double SerializeStartTime = Profiler ? FPlatformTime::Seconds() : 0.0;
+
 	// Write out a stub for the size of the object data. We'll rewrite it with the correct size later.
 	const int64 ObjectLengthPos = Tell();
 	uint32 ObjectLength = 0;
@@ -152,6 +187,11 @@ uint32 FSaveGameArchive::WriteObjectAndLength(UObject* Object)
 	// Calculate the actual object size and seek back and rewrite it.
 	ObjectLength = ObjectEndPos - ObjectLengthPos - sizeof(uint32);
 
+	if (Profiler)
+	{
+		Profiler->AddObject(Object->GetClass(), FPlatformTime::Seconds() - SerializeStartTime, ObjectLength);
+	}
+
 	Seek(ObjectLengthPos);
 	*this << ObjectLength;
 	Seek(ObjectEndPos);
@@ -403,8 +443,44 @@ void FSaveGameArchive::ReadBaseObject(UObject* BaseObject)
 				}
 				else
 				{
-					// Create a new instance
-					Objects[i] = NewObject<UObject>(Outer, Class, ObjectName);
+					// If the outer already has an object with this name and class (for instance, a subobject created in
+					// the constructor) just read into that instead of creating a new one.
+					UObject* ExistingObject = StaticFindObjectFast(UObject::StaticClass(), Outer, ObjectName);
+
+					if (ExistingObject != nullptr && ExistingObject->GetClass() == Class && IsValid(ExistingObject))
+					{
+						INC_DWORD_STAT(STAT_PersistenceGunfire_ObjectsReused);
+
+						// Properties that matched the archetype when they were saved weren't written out, so put them
+						// back to the archetype's values first. Otherwise they'd keep whatever the existing object had
+						// changed them to, instead of matching a newly created object.
+						if (const UObject* Archetype = ExistingObject->GetArchetype())
+						{
+							for (TFieldIterator<FProperty> PropIt(Class); PropIt; ++PropIt)
+							{
+								if (PropIt->HasAnyPropertyFlags(CPF_SaveGame))
+								{
+									PropIt->CopyCompleteValue_InContainer(ExistingObject, Archetype);
+								}
+							}
+						}
+
+						Objects[i] = ExistingObject;
+					}
+					else
+					{
+						INC_DWORD_STAT(STAT_PersistenceGunfire_ObjectsCreated);
+
+						// Creating an object with the same name as an existing one of a different class is fatal, so
+						// in that case fall back to a unique name.
+						if (ExistingObject != nullptr)
+						{
+							ObjectName = MakeUniqueObjectName(Outer, Class, ObjectName);
+						}
+
+						// Create a new instance
+						Objects[i] = NewObject<UObject>(Outer, Class, ObjectName);
+					}
 				}
 			}
 			else
@@ -463,10 +539,168 @@ void FSaveGameArchive::ReadBaseObject(UObject* BaseObject)
 	Objects.SetNum(0);
 }
 
+void FSaveGameArchive::DescribeBaseObject(FPersistenceSizeReport& Report, const FString& BaseClassName)
+{
+	using ECategory = FPersistenceSizeReport::ECategory;
+
+	const int64 HeaderStart = Tell();
+
+	int64 ObjectIndexPos;
+	*this << ObjectIndexPos;
+	const int64 StartPos = Tell();
+
+	Seek(ObjectIndexPos);
+
+	int32 NumUniqueObjects;
+	*this << NumUniqueObjects;
+
+	// Read the index just for the class names, the objects themselves are never looked up
+	TArray<FString> ClassNames;
+	ClassNames.SetNum(FMath::Max(NumUniqueObjects, 0));
+
+	for (int32 i = 0; i < ClassNames.Num(); i++)
+	{
+		uint8 WasLoaded;
+		*this << WasLoaded;
+
+		FSoftObjectPath ObjectPath;
+		*this << ObjectPath;
+
+		if (WasLoaded)
+		{
+			ClassNames[i] = (i == 0) ? BaseClassName : FString::Printf(TEXT("Placed Object (%s)"), *ObjectPath.GetAssetName());
+		}
+		else
+		{
+			FName ObjectName;
+			*this << ObjectName;
+
+			int32 OuterIndex;
+			*this << OuterIndex;
+
+			ClassNames[i] = ObjectPath.GetAssetName();
+		}
+	}
+
+	const int64 IndexEnd = Tell();
+	Report.Add(ECategory::Overhead, TEXT("Object Index"), IndexEnd - ObjectIndexPos + (StartPos - HeaderStart));
+
+	int64 EndPos = IndexEnd;
+
+	if (!IsSharedNameCache())
+	{
+		NameCache.Serialize(*this);
+		EndPos = Tell();
+
+		Report.Add(ECategory::Overhead, TEXT("Name Cache"), EndPos - IndexEnd);
+	}
+
+	Seek(StartPos);
+
+	for (int32 i = 0; i < ClassNames.Num() && !IsError(); i++)
+	{
+		int32 ObjectIndex;
+		*this << ObjectIndex;
+
+		uint32 ObjectLength;
+		*this << ObjectLength;
+
+		const FString& ClassName = ClassNames.IsValidIndex(ObjectIndex) ? ClassNames[ObjectIndex] : FString(TEXT("Unknown"));
+
+		// The base object is attributed by the caller, everything else is a subobject (class references have no data)
+		if (ObjectIndex != 0 && ObjectLength > 0)
+		{
+			Report.Add(ECategory::SubobjectClass, ClassName, ObjectLength);
+		}
+
+		DescribeProperties(Report, ClassName, ObjectLength);
+
+		uint8 IsActor;
+		*this << IsActor;
+
+		if (IsActor)
+		{
+			int32 ComponentCount;
+			*this << ComponentCount;
+
+			for (int32 j = 0; j < ComponentCount && !IsError(); j++)
+			{
+				FName ComponentKey;
+				*this << ComponentKey;
+
+				uint32 ComponentLength;
+				*this << ComponentLength;
+
+				const FString ComponentName = FString::Printf(TEXT("%s.%s"), *ClassName, *ComponentKey.ToString());
+
+				Report.Add(ECategory::Component, ComponentName, ComponentLength);
+
+				DescribeProperties(Report, ComponentName, ComponentLength);
+			}
+		}
+	}
+
+	Seek(EndPos);
+}
+
+void FSaveGameArchive::DescribeProperties(FPersistenceSizeReport& Report, const FString& OwnerName, uint32 Length)
+{
+	using ECategory = FPersistenceSizeReport::ECategory;
+
+	const int64 ObjectStart = Tell();
+	const int64 ObjectEnd = ObjectStart + Length;
+
+	if (Length == 0)
+	{
+		return;
+	}
+
+	// Newer engine versions write a control byte before the tagged properties, with an extra byte following it if the
+	// overridable serialization info bit is set.
+	if (UEVer() >= EUnrealEngineObjectUE5Version::PROPERTY_TAG_EXTENSION_AND_OVERRIDABLE_SERIALIZATION)
+	{
+		uint8 SerializationControl = 0;
+		*this << SerializationControl;
+
+		if (SerializationControl & 0x02)
+		{
+			uint8 OverriddenOperation = 0;
+			*this << OverriddenOperation;
+		}
+	}
+
+	// Walk the property tags, skipping over the values. Whatever is left (the terminating tag and any native
+	// serialization) is reported as a single entry for the object.
+	while (Tell() < ObjectEnd && !IsError())
+	{
+		const int64 TagStart = Tell();
+
+		FPropertyTag Tag;
+		*this << Tag;
+
+		if (Tag.Name.IsNone())
+		{
+			break;
+		}
+
+		Seek(Tell() + Tag.Size);
+
+		Report.Add(ECategory::Property, FString::Printf(TEXT("%s.%s"), *OwnerName, *Tag.Name.ToString()), Tell() - TagStart);
+	}
+
+	if (Tell() < ObjectEnd)
+	{
+		Report.Add(ECategory::Property, FString::Printf(TEXT("%s.(native)"), *OwnerName), ObjectEnd - Tell());
+	}
+
+	Seek(ObjectEnd);
+}
+
 void FSaveGameArchive::WriteComponents(AActor* Actor, TMap<FName, bool>& ClassCache)
 {
 	// Write Component Data
-	TInlineComponentArray<UActorComponent*> ActorComponents(Actor);
+	ActorComponents.Reset();
+	Actor->GetComponents(ActorComponents);
 
 	int32 ComponentCount = 0;
 
@@ -502,7 +736,7 @@ void FSaveGameArchive::ReadComponents(AActor* Actor)
 	int32 ComponentCount;
 	*this << ComponentCount;
 
-	TInlineComponentArray<UActorComponent*> ActorComponents;
+	ActorComponents.Reset();
 
 	if (Actor)
 	{
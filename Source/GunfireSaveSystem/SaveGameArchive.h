@@ -4,11 +4,13 @@
 
 #include "Serialization/ObjectAndNameAsStringProxyArchive.h"
 
+struct FPersistenceSizeReport;
+
 //
 // A helper for serializing FName's with less waste by only serializing the string once, regardless of how many times
 // it's used.
 //
-struct FNameCache
+struct GUNFIRESAVESYSTEM_API FNameCache
 {
 public:
 	// Adds a name to the cache and returns a unique id for looking it up on load
@@ -20,6 +22,8 @@ public:
 
 	void Reset();
 
+	SIZE_T GetAllocatedSize() const { return NameMap.GetAllocatedSize() + Names.GetAllocatedSize(); }
+
 private:
 	TMap<FName, int32> NameMap;
 	TArray<FName> Names;
@@ -37,6 +41,16 @@ public:
 	// name cache instead of letting each archive write their own. It's up to the caller to serialize the shared cache.
 	FSaveGameArchive(FArchive& InInnerArchive, FNameCache* SharedNameCache = nullptr);
 
+	// For reading or writing many base objects with one archive. The version isn't serialized, it's up to the caller to
+	// store it along with the shared name cache. Reset must be called before each base object is read or written.
+	FSaveGameArchive(FArchive& InInnerArchive, FNameCache& SharedNameCache, int32 SharedVersion);
+
+	// Clears any state from the last base object, keeping allocations around for the next one
+	void Reset();
+
+	// The version that archives are currently written with
+	static int32 GetLatestVersion();
+
 	void SetNoDelta(bool NoDelta) { ArNoDelta = NoDelta; }
 
 	// Call this before ReadBaseObject to get a list of any classes that need to be loaded, so you can load them in
@@ -48,11 +62,27 @@ public:
 	void WriteBaseObject(UObject* BaseObject, TMap<FName, bool>& ClassCache);
 	void ReadBaseObject(UObject* BaseObject);
 
+	// Walks the data for a base object without creating or loading anything, adding the size of each object, component
+	// and property to the report. BaseClassName is used for the base object if its class wasn't written (placed actors).
+	void DescribeBaseObject(FPersistenceSizeReport& Report, const FString& BaseClassName);
+
+#if !UE_BUILD_SHIPPING
+	// The individual serialization steps, so tools like the benchmark commandlet can time them on their own. Nothing
+	// else should use these.
+	void SerializeNameForTesting(FName& Name) { *this << Name; }
+	void SerializeObjectForTesting(UObject*& Object) { *this << Object; }
+	uint32 WriteObjectAndLengthForTesting(UObject* Object) { return WriteObjectAndLength(Object); }
+	void WriteComponentsForTesting(AActor* Actor, TMap<FName, bool>& ClassCache) { WriteComponents(Actor, ClassCache); }
+	void ReadComponentsForTesting(AActor* Actor) { ReadComponents(Actor); }
+	void SeekForTesting(int64 Position) { Seek(Position); }
+#endif
+
 private:
 	bool IsSharedNameCache() const { return &NameCache != &LocalNameCache; }
 	uint32 WriteObjectAndLength(UObject* Object);
 	void WriteComponents(AActor* Actor, TMap<FName, bool>& ClassCache);
 	void ReadComponents(AActor* Actor);
+	void DescribeProperties(FPersistenceSizeReport& Report, const FString& OwnerName, uint32 Length);
 
 	// Returns true if this class has any SaveGame flagged properties
 	bool CheckClassNeedsSaving(UClass* Class, TMap<FName, bool>& ClassCache);
@@ -73,6 +103,9 @@ private:
 	// A queue of objects waiting to be serialized
 	TArray<UObject*> ObjectsToSerialize;
 
+	// Scratch space for gathering actor components, kept around so it doesn't need to be reallocated for each actor
+	TArray<UActorComponent*> ActorComponents;
+
 	FNameCache& NameCache;
 	FNameCache LocalNameCache;
 };
@@ -0,0 +1,86 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "SaveGameWorld.h"
+
+#include "GunfireSaveSystemVersion.h"
+#include "PersistenceContainer.h"
+#include "PersistenceSaveData.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(SaveGameWorld)
+
+void USaveGameWorld::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	if (Ar.IsSaveGame())
+	{
+		Ar.UsingCustomVersion(FGunfireSaveSystemVersion::GUID);
+
+		// Saves from before the custom version was added stored containers as objects, in which case they'll be in
+		// LegacyContainers instead.
+		const FCustomVersion* CustomVersion = Ar.GetCustomVersions().GetVersion(FGunfireSaveSystemVersion::GUID);
+		const int32 Version = CustomVersion ? CustomVersion->Version : FGunfireSaveSystemVersion::BeforeCustomVersionWasAdded;
+
+		if (Ar.IsSaving() || Version >= FGunfireSaveSystemVersion::NonObjectContainers)
+		{
+			int32 NumContainers = Containers.Num();
+			Ar << NumContainers;
+
+			if (Ar.IsLoading())
+			{
+				Containers.Reset(NumContainers);
+
+				for (int32 i = 0; i < NumContainers; ++i)
+				{
+					Containers.Add(MakeShared<FPersistenceContainer>());
+				}
+			}
+
+			if (Ar.IsSaving())
+			{
+				// Containers are added in whatever order levels happen to stream in, so write them sorted by key.
+				// Otherwise two saves of the same game would have their containers shuffled around, which makes delta
+				// backups (and comparing saves in general) much less effective.
+				TArray<FPersistenceContainer*, TInlineAllocator<64>> SortedContainers;
+				SortedContainers.Reserve(Containers.Num());
+
+				for (const TSharedPtr<FPersistenceContainer>& Container : Containers)
+				{
+					SortedContainers.Add(Container.Get());
+				}
+
+				SortedContainers.StableSort([](const FPersistenceContainer& A, const FPersistenceContainer& B)
+				{
+					return A.GetKey().Compare(B.GetKey()) < 0;
+				});
+
+				for (FPersistenceContainer* Container : SortedContainers)
+				{
+					Container->Serialize(Ar, LoadingSaveData);
+				}
+			}
+			else
+			{
+				for (const TSharedPtr<FPersistenceContainer>& Container : Containers)
+				{
+					Container->Serialize(Ar, LoadingSaveData);
+				}
+			}
+		}
+	}
+}
+
+void USaveGameWorld::MigrateLegacyContainers()
+{
+	for (UPersistenceContainer* LegacyContainer : LegacyContainers)
+	{
+		if (LegacyContainer != nullptr)
+		{
+			Containers.Add(MakeShared<FPersistenceContainer>(LegacyContainer->Key, MoveTemp(LegacyContainer->Blob.Data)));
+
+			LegacyContainer->MarkAsGarbage();
+		}
+	}
+
+	LegacyContainers.Empty();
+}
@@ -5,6 +5,9 @@
 #include "SaveGamePersistence.h"
 #include "SaveGameWorld.generated.h"
 
+class FPersistenceContainer;
+class FPersistenceSaveData;
+
 //
 // The save game class for persistent world data. Any data from persistence components will be automatically saved in
 // here. If there is project specific data this can be subclassed and new data added as properties (with the SaveGame
@@ -21,9 +24,24 @@ public:
 	UPROPERTY(SaveGame, BlueprintReadOnly)
 	bool RequiresFullGame = false;
 
+	virtual void Serialize(FArchive& Ar) override;
+
+	TConstArrayView<TSharedPtr<FPersistenceContainer>> GetContainers() const { return Containers; }
+
 protected:
+	// Moves any containers that were loaded from a save that still stored them as objects into Containers. This needs
+	// to be called after the save is completely read in, since the legacy objects are read after the world save.
+	void MigrateLegacyContainers();
+
+	// The save this is being read from, while it's being read. Containers keep their data in it instead of copying it.
+	TSharedPtr<const FPersistenceSaveData> LoadingSaveData;
+
 	// Save data for each level in the world with persistent actors. Containers will also be created for actors that use
-	// a save key.
-	UPROPERTY(SaveGame, BlueprintReadOnly)
-	TArray<TObjectPtr<class UPersistenceContainer>> Containers;
+	// a save key. These are serialized after our tagged properties.
+	TArray<TSharedPtr<FPersistenceContainer>> Containers;
+
+	// Containers from saves written before they stopped being UObjects. This is only filled in while loading an old
+	// save (the old Containers property is redirected here), and it's emptied by MigrateLegacyContainers.
+	UPROPERTY(SaveGame)
+	TArray<TObjectPtr<class UPersistenceContainer>> LegacyContainers;
 };
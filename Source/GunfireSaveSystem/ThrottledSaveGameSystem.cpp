@@ -0,0 +1,86 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "ThrottledSaveGameSystem.h"
+
+#include "PlatformFeatures.h"
+
+TAutoConsoleVariable<float> CVarPersistenceThrottleLatencyMs(TEXT("SaveSystem.Throttle.LatencyMs"), 10.f, TEXT("The minimum time for each operation with the throttled save backend"));
+TAutoConsoleVariable<float> CVarPersistenceThrottleReadMBps(TEXT("SaveSystem.Throttle.ReadMBps"), 50.f, TEXT("The read bandwidth for the throttled save backend, in MB per second (0 for unlimited)"));
+TAutoConsoleVariable<float> CVarPersistenceThrottleWriteMBps(TEXT("SaveSystem.Throttle.WriteMBps"), 20.f, TEXT("The write bandwidth for the throttled save backend, in MB per second (0 for unlimited)"));
+
+FThrottledSaveGameSystem& FThrottledSaveGameSystem::Get()
+{
+	static FThrottledSaveGameSystem System;
+	return System;
+}
+
+ISaveGameSystem& FThrottledSaveGameSystem::GetInner() const
+{
+	if (Inner != nullptr)
+	{
+		return *Inner;
+	}
+
+	return *IPlatformFeaturesModule::Get().GetSaveGameSystem();
+}
+
+void FThrottledSaveGameSystem::Throttle(double StartTime, int64 NumBytes, float MBps)
+{
+	double Seconds = CVarPersistenceThrottleLatencyMs.GetValueOnAnyThread() / 1000.0;
+
+	if (MBps > 0.f)
+	{
+		Seconds += NumBytes / (MBps * 1024.0 * 1024.0);
+	}
+
+	const double Remaining = StartTime + Seconds - FPlatformTime::Seconds();
+
+	if (Remaining > 0.0)
+	{
+		FPlatformProcess::Sleep(static_cast<float>(Remaining));
+	}
+}
+
+ISaveGameSystem::ESaveExistsResult FThrottledSaveGameSystem::DoesSaveGameExistWithResult(const TCHAR* Name, const int32 UserIndex)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	const ESaveExistsResult Result = GetInner().DoesSaveGameExistWithResult(Name, UserIndex);
+
+	Throttle(StartTime, 0, 0.f);
+
+	return Result;
+}
+
+bool FThrottledSaveGameSystem::SaveGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, const TArray<uint8>& Data)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	const bool bResult = GetInner().SaveGame(bAttemptToUseUI, Name, UserIndex, Data);
+
+	Throttle(StartTime, Data.Num(), CVarPersistenceThrottleWriteMBps.GetValueOnAnyThread());
+
+	return bResult;
+}
+
+bool FThrottledSaveGameSystem::LoadGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, TArray<uint8>& Data)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	const bool bResult = GetInner().LoadGame(bAttemptToUseUI, Name, UserIndex, Data);
+
+	Throttle(StartTime, Data.Num(), CVarPersistenceThrottleReadMBps.GetValueOnAnyThread());
+
+	return bResult;
+}
+
+bool FThrottledSaveGameSystem::DeleteGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	const bool bResult = GetInner().DeleteGame(bAttemptToUseUI, Name, UserIndex);
+
+	Throttle(StartTime, 0, 0.f);
+
+	return bResult;
+}
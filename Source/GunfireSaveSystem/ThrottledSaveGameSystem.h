@@ -0,0 +1,37 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "SaveGameSystem.h"
+
+//
+// Wraps another save game system, and slows it down to emulate slower storage. Every operation takes at least
+// SaveSystem.Throttle.LatencyMs, and reads and writes are limited to SaveSystem.Throttle.ReadMBps and
+// SaveSystem.Throttle.WriteMBps. This makes it possible to see how the save system behaves with console storage on a
+// fast dev machine, which SaveSystem.JobDelay can't do since it delays every job by the same amount regardless of size.
+//
+// Select it with SaveSystem.Backend Throttled (not available in shipping builds).
+//
+class GUNFIRESAVESYSTEM_API FThrottledSaveGameSystem : public FGenericSaveGameSystem
+{
+public:
+	// Sets the save system to pass operations through to, which is the platform save system by default
+	void SetInner(ISaveGameSystem* InInner) { Inner = InInner; }
+
+	// ISaveGameSystem Begin
+	virtual ESaveExistsResult DoesSaveGameExistWithResult(const TCHAR* Name, const int32 UserIndex) override;
+	virtual bool SaveGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, const TArray<uint8>& Data) override;
+	virtual bool LoadGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex, TArray<uint8>& Data) override;
+	virtual bool DeleteGame(bool bAttemptToUseUI, const TCHAR* Name, const int32 UserIndex) override;
+	// ISaveGameSystem End
+
+	static FThrottledSaveGameSystem& Get();
+
+protected:
+	ISaveGameSystem& GetInner() const;
+
+	// Sleeps until the operation that started at StartTime has taken as long as it would on throttled storage
+	static void Throttle(double StartTime, int64 NumBytes, float MBps);
+
+	ISaveGameSystem* Inner = nullptr;
+};
@@ -0,0 +1,28 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// The save system benchmark commandlet and the synthetic actors it uses, along with other offline tools like the save
+// size report commandlet. This is a developer tool module, so none of it ends up in shipping builds.
+public class GunfireSaveSystemBenchmark : ModuleRules
+{
+	public GunfireSaveSystemBenchmark(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+				"GunfireSaveSystem",
+				"Json",
+			}
+		);
+	}
+}
@@ -0,0 +1,9 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "GunfireSaveSystemBenchmark.h"
+
+#include "Modules/ModuleManager.h"
+
+DEFINE_LOG_CATEGORY(LogPersistenceBenchmark);
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, GunfireSaveSystemBenchmark)
@@ -0,0 +1,80 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceBenchmarkActor.h"
+
+#include "PersistenceComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PersistenceBenchmarkActor)
+
+static FString RandomString(FRandomStream& Random, int32 MinLength, int32 MaxLength)
+{
+	const int32 Length = Random.RandRange(MinLength, MaxLength);
+
+	FString Result;
+	Result.Reserve(Length);
+
+	for (int32 i = 0; i < Length; i++)
+	{
+		Result.AppendChar(static_cast<TCHAR>(Random.RandRange('a', 'z')));
+	}
+
+	return Result;
+}
+
+void UPersistenceBenchmarkObject::Randomize(FRandomStream& Random, int32 Depth)
+{
+	Value = Random.RandHelper(1000);
+	Text = RandomString(Random, 4, 24);
+
+	if (Depth > 0)
+	{
+		if (Child == nullptr)
+		{
+			Child = NewObject<UPersistenceBenchmarkObject>(this, TEXT("Child"));
+		}
+
+		Child->Randomize(Random, Depth - 1);
+	}
+}
+
+void UPersistenceBenchmarkComponent::Randomize(FRandomStream& Random)
+{
+	Value = Random.FRand() * 100.f;
+	bFlag = Random.RandHelper(2) != 0;
+
+	Tags.SetNum(Random.RandRange(0, 4));
+	for (FName& Tag : Tags)
+	{
+		Tag = FName(TEXT("Tag"), Random.RandHelper(16));
+	}
+}
+
+APersistenceBenchmarkActor::APersistenceBenchmarkActor()
+{
+	Persistence = CreateDefaultSubobject<UPersistenceComponent>(TEXT("Persistence"));
+}
+
+void APersistenceBenchmarkActor::Setup(FRandomStream& Random, int32 NumComponents, int32 SubobjectDepth)
+{
+	Health = Random.RandRange(0, 100);
+	DisplayName = RandomString(Random, 8, 32);
+
+	Inventory.SetNum(Random.RandRange(0, 16));
+	for (int32& Item : Inventory)
+	{
+		Item = Random.RandHelper(10000);
+	}
+
+	for (int32 i = 0; i < NumComponents; i++)
+	{
+		UPersistenceBenchmarkComponent* Component = NewObject<UPersistenceBenchmarkComponent>(this, FName(TEXT("BenchmarkComponent"), i + 1));
+		Component->RegisterComponent();
+		Component->Randomize(Random);
+	}
+
+	if (SubobjectDepth > 0)
+	{
+		Subobject = NewObject<UPersistenceBenchmarkObject>(this, TEXT("Subobject"));
+		Subobject->Randomize(Random, SubobjectDepth - 1);
+	}
+}
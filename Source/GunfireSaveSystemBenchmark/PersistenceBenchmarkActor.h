@@ -0,0 +1,83 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "GameFramework/Actor.h"
+
+#include "PersistenceBenchmarkActor.generated.h"
+
+class UPersistenceComponent;
+
+//
+// Synthetic persistent types used by the PersistenceBenchmark commandlet. They're filled in with random save data that
+// roughly resembles typical gameplay state (a few scalars, a string, and some arrays).
+//
+
+UCLASS(NotBlueprintable, NotBlueprintType, HideDropdown)
+class UPersistenceBenchmarkObject : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Fills in random data, and creates a chain of child objects Depth deep below this one
+	void Randomize(FRandomStream& Random, int32 Depth);
+
+	UPROPERTY(SaveGame)
+	int32 Value = 0;
+
+	UPROPERTY(SaveGame)
+	FString Text;
+
+	UPROPERTY(SaveGame)
+	TObjectPtr<UPersistenceBenchmarkObject> Child;
+};
+
+UCLASS(NotBlueprintable, NotBlueprintType, HideDropdown)
+class UPersistenceBenchmarkComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	void Randomize(FRandomStream& Random);
+
+	UPROPERTY(SaveGame)
+	float Value = 0.f;
+
+	UPROPERTY(SaveGame)
+	bool bFlag = false;
+
+	UPROPERTY(SaveGame)
+	TArray<FName> Tags;
+};
+
+UCLASS(NotBlueprintable, NotBlueprintType, NotPlaceable, HideDropdown)
+class APersistenceBenchmarkActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	APersistenceBenchmarkActor();
+
+	// Adds NumComponents saved components and a subobject chain SubobjectDepth deep, and fills everything in with
+	// random data.
+	void Setup(FRandomStream& Random, int32 NumComponents, int32 SubobjectDepth);
+
+	UPersistenceComponent* GetPersistenceComponent() const { return Persistence; }
+
+	UPROPERTY(SaveGame)
+	int32 Health = 0;
+
+	UPROPERTY(SaveGame)
+	FString DisplayName;
+
+	UPROPERTY(SaveGame)
+	TArray<int32> Inventory;
+
+	UPROPERTY(SaveGame)
+	TObjectPtr<UPersistenceBenchmarkObject> Subobject;
+
+protected:
+	UPROPERTY()
+	TObjectPtr<UPersistenceComponent> Persistence;
+};
@@ -0,0 +1,1354 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceBenchmarkCommandlet.h"
+
+#include "GunfireSaveSystemBenchmark.h"
+#include "PersistenceBenchmarkActor.h"
+#include "PersistenceComponent.h"
+#include "PersistenceContainer.h"
+#include "PersistenceIOEngine.h"
+#include "PersistenceSaveData.h"
+#include "PersistenceManager.h"
+#include "GunfireSaveSystemVersion.h"
+#include "SaveGameArchive.h"
+#include "SaveGameWorld.h"
+
+#include "Async/TaskGraphInterfaces.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PersistenceBenchmarkCommandlet)
+
+struct FPersistenceBenchmarkScenario
+{
+	int32 Seed = 1;
+	int32 NumLevels = 10;
+	int32 ActorsPerLevel = 200;
+	int32 ComponentsPerActor = 2;
+	int32 SubobjectDepth = 1;
+	float DynamicFraction = 0.25f;
+	float DestroyedFraction = 0.05f;
+	float TransformFraction = 0.5f;
+
+	void Parse(const TCHAR* Params)
+	{
+		FParse::Value(Params, TEXT("Seed="), Seed);
+		FParse::Value(Params, TEXT("Levels="), NumLevels);
+		FParse::Value(Params, TEXT("Actors="), ActorsPerLevel);
+		FParse::Value(Params, TEXT("Components="), ComponentsPerActor);
+		FParse::Value(Params, TEXT("Depth="), SubobjectDepth);
+		FParse::Value(Params, TEXT("Dynamic="), DynamicFraction);
+		FParse::Value(Params, TEXT("Destroyed="), DestroyedFraction);
+		FParse::Value(Params, TEXT("Transform="), TransformFraction);
+	}
+
+	TSharedRef<FJsonObject> ToJson() const
+	{
+		TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetNumberField(TEXT("Seed"), Seed);
+		Json->SetNumberField(TEXT("Levels"), NumLevels);
+		Json->SetNumberField(TEXT("ActorsPerLevel"), ActorsPerLevel);
+		Json->SetNumberField(TEXT("ComponentsPerActor"), ComponentsPerActor);
+		Json->SetNumberField(TEXT("SubobjectDepth"), SubobjectDepth);
+		Json->SetNumberField(TEXT("DynamicFraction"), DynamicFraction);
+		Json->SetNumberField(TEXT("DestroyedFraction"), DestroyedFraction);
+		Json->SetNumberField(TEXT("TransformFraction"), TransformFraction);
+		return Json;
+	}
+};
+
+// A synthetic actor that's still around after spawning a scenario, and the container it was registered to
+struct FPersistenceBenchmarkActorInfo
+{
+	APersistenceBenchmarkActor* Actor = nullptr;
+	FName ContainerKey;
+};
+
+// The samples for each stage of a benchmark, across all iterations
+struct FPersistenceBenchmarkResults
+{
+	void Add(const FString& Stage, double Value)
+	{
+		for (TPair<FString, TArray<double>>& Existing : Stages)
+		{
+			if (Existing.Key == Stage)
+			{
+				Existing.Value.Add(Value);
+				return;
+			}
+		}
+
+		Stages.Emplace(Stage, TArray<double>({ Value }));
+	}
+
+	TSharedRef<FJsonObject> ToJson() const
+	{
+		TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+
+		for (const TPair<FString, TArray<double>>& Stage : Stages)
+		{
+			TArray<double> Sorted = Stage.Value;
+			Sorted.Sort();
+
+			double Total = 0.0;
+			for (double Value : Sorted)
+			{
+				Total += Value;
+			}
+
+			TSharedRef<FJsonObject> StageJson = MakeShared<FJsonObject>();
+			StageJson->SetNumberField(TEXT("Min"), Sorted[0]);
+			StageJson->SetNumberField(TEXT("Median"), Sorted[Sorted.Num() / 2]);
+			StageJson->SetNumberField(TEXT("Avg"), Total / Sorted.Num());
+			StageJson->SetNumberField(TEXT("Max"), Sorted.Last());
+
+			Json->SetObjectField(Stage.Key, StageJson);
+		}
+
+		return Json;
+	}
+
+	void Log() const
+	{
+		for (const TPair<FString, TArray<double>>& Stage : Stages)
+		{
+			double Total = 0.0;
+			for (double Value : Stage.Value)
+			{
+				Total += Value;
+			}
+
+			UE_LOG(LogPersistenceBenchmark, Display, TEXT("  %-24s %12.3f avg"), *Stage.Key, Total / Stage.Value.Num());
+		}
+	}
+
+	// Kept in the order they were first added, so the output follows the order of the stages
+	TArray<TPair<FString, TArray<double>>> Stages;
+};
+
+static double MillisecondsSince(double StartTime)
+{
+	return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
+
+// Sizes for the micro benchmarks
+static const int32 MicroNumOps = 100000;
+static const int32 MicroNumUniqueNames = 1024;
+static const int32 MicroNumGraphObjects = 4096;
+static const int32 MicroNumObjectWrites = 10000;
+static const int32 MicroNumComponents = 64;
+static const int32 MicroSubobjectDepth = 16;
+static const int32 MicroHeaderPayloadBytes = 16 * 1024 * 1024;
+
+// Sizes for the I/O benchmarks, roughly a server's worth of world saves
+static const int32 IONumFiles = 16;
+static const int32 IOFileBytes = 4 * 1024 * 1024;
+
+// Runs Batch Runs times plus a warm up run, and adds the fastest one to Results. Batch returns the number of operations
+// it did, and sets the number of bytes it processed (or leaves it at zero if bytes aren't meaningful for it).
+static void RunMicroBenchmark(FJsonObject& Results, const TCHAR* Name, int32 Runs, TFunctionRef<int64(int64& OutBytes)> Batch)
+{
+	int64 NumOps = 0;
+	int64 NumBytes = 0;
+
+	// Warm up, so the first run doesn't pay for growing allocations and cold caches
+	Batch(NumBytes);
+
+	double BestSeconds = DBL_MAX;
+
+	for (int32 Run = 0; Run < Runs; Run++)
+	{
+		NumBytes = 0;
+
+		const double StartTime = FPlatformTime::Seconds();
+		NumOps = Batch(NumBytes);
+		BestSeconds = FMath::Min(BestSeconds, FPlatformTime::Seconds() - StartTime);
+	}
+
+	BestSeconds = FMath::Max(BestSeconds, UE_DOUBLE_SMALL_NUMBER);
+
+	const double NsPerOp = BestSeconds * 1e9 / FMath::Max<int64>(NumOps, 1);
+	const double MBPerSec = NumBytes / BestSeconds / (1024.0 * 1024.0);
+
+	UE_LOG(LogPersistenceBenchmark, Display, TEXT("  %-28s %12.1f ns/op %10.1f MB/s"), Name, NsPerOp, MBPerSec);
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("Ops"), NumOps);
+	Json->SetNumberField(TEXT("Bytes"), NumBytes);
+	Json->SetNumberField(TEXT("NsPerOp"), NsPerOp);
+	Json->SetNumberField(TEXT("MBPerSec"), MBPerSec);
+
+	Results.SetObjectField(Name, Json);
+}
+
+// The scenarios run by -Reference. These are the cases we most want to keep from getting slower: a commit of a
+// large number of actors, a world split up into lots of small containers (and a save with thousands of them, for
+// garbage collection), and a large save with heavy actors.
+static TArray<TPair<FString, FPersistenceBenchmarkScenario>> GetReferenceScenarios(int32 Seed)
+{
+	TArray<TPair<FString, FPersistenceBenchmarkScenario>> Scenarios;
+
+	FPersistenceBenchmarkScenario Commit5k;
+	Commit5k.Seed = Seed;
+	Commit5k.NumLevels = 25;
+	Commit5k.ActorsPerLevel = 200;
+	Scenarios.Emplace(TEXT("Commit5k"), Commit5k);
+
+	FPersistenceBenchmarkScenario Containers500;
+	Containers500.Seed = Seed;
+	Containers500.NumLevels = 500;
+	Containers500.ActorsPerLevel = 10;
+	Scenarios.Emplace(TEXT("Containers500"), Containers500);
+
+	FPersistenceBenchmarkScenario Containers5k;
+	Containers5k.Seed = Seed;
+	Containers5k.NumLevels = 5000;
+	Containers5k.ActorsPerLevel = 2;
+	Scenarios.Emplace(TEXT("Containers5k"), Containers5k);
+
+	FPersistenceBenchmarkScenario LargeSave;
+	LargeSave.Seed = Seed;
+	LargeSave.NumLevels = 40;
+	LargeSave.ActorsPerLevel = 500;
+	LargeSave.ComponentsPerActor = 4;
+	LargeSave.SubobjectDepth = 3;
+	Scenarios.Emplace(TEXT("LargeSave"), LargeSave);
+
+	return Scenarios;
+}
+
+// A metric compared against a baseline. Times get a tolerance and lower is better, but counts (the size of the save, the
+// number of actors spawned) come from a seeded scenario, so any change to them means the run didn't do the same work.
+struct FPersistenceBaselineMetric
+{
+	FString Name;
+	double Value = 0.0;
+	bool bIsCount = false;
+};
+
+// The top level sections of a benchmark's output that hold results, one for each mode
+static const TCHAR* const BenchmarkModeFields[] = { TEXT("World"), TEXT("Micro"), TEXT("IO"), TEXT("Reference"), TEXT("RoundTrip") };
+
+// Gathers every metric we compare against a baseline, which is the median of each stage and the time per operation
+// for micro benchmarks. Stage names ending in Ms and micro benchmark times are times, any other stage is a count. The
+// scenario settings are inputs, so they're skipped.
+static void GatherBaselineMetrics(const FJsonObject& Object, const FString& Path, TArray<FPersistenceBaselineMetric>& OutMetrics)
+{
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object.Values)
+	{
+		if (Field.Key == TEXT("Scenario") || Field.Key == TEXT("Tolerances"))
+		{
+			continue;
+		}
+
+		const TSharedPtr<FJsonObject>* Child = nullptr;
+		double Value = 0.0;
+
+		if (Field.Value->TryGetObject(Child))
+		{
+			GatherBaselineMetrics(**Child, Path.IsEmpty() ? Field.Key : Path + TEXT(".") + Field.Key, OutMetrics);
+		}
+		else if (Field.Key == TEXT("NsPerOp") && Field.Value->TryGetNumber(Value))
+		{
+			OutMetrics.Add({ Path, Value, false });
+		}
+		else if (Field.Key == TEXT("Median") && Field.Value->TryGetNumber(Value))
+		{
+			OutMetrics.Add({ Path, Value, !Path.EndsWith(TEXT("Ms")) });
+		}
+	}
+}
+
+// Gathers the scenario settings for every benchmark that has them, serialized so they can be compared
+static void GatherBaselineScenarios(const FJsonObject& Object, const FString& Path, TMap<FString, FString>& OutScenarios)
+{
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object.Values)
+	{
+		const TSharedPtr<FJsonObject>* Child = nullptr;
+
+		if (!Field.Value->TryGetObject(Child))
+		{
+			continue;
+		}
+
+		const FString ChildPath = Path.IsEmpty() ? Field.Key : Path + TEXT(".") + Field.Key;
+
+		if (Field.Key == TEXT("Scenario"))
+		{
+			FString Serialized;
+			TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Serialized);
+			FJsonSerializer::Serialize(Child->ToSharedRef(), Writer);
+
+			OutScenarios.Add(ChildPath, Serialized);
+		}
+		else
+		{
+			GatherBaselineScenarios(**Child, ChildPath, OutScenarios);
+		}
+	}
+}
+
+// Prints a table comparing each metric in the baseline to the current results, and returns the number of failures. A
+// time fails if it got worse by more than its tolerance, a count fails if it changed at all, and a metric fails if it's
+// missing from the current results. Runs of a different mode or scenario than the baseline fail outright, since none of
+// their metrics can be compared. A baseline can override the tolerance for a time with a Tolerances object, keyed by
+// either the full metric name (Reference.Commit5k.Results.CommitMs) or just the stage (CommitMs).
+static int32 CompareToBaseline(const FJsonObject& Baseline, const FJsonObject& Current, double DefaultTolerance, double MinDelta)
+{
+	int32 NumFailures = 0;
+
+	for (const TCHAR* ModeField : BenchmarkModeFields)
+	{
+		const bool bInBaseline = Baseline.HasField(ModeField);
+		const bool bInCurrent = Current.HasField(ModeField);
+
+		if (bInBaseline != bInCurrent)
+		{
+			UE_LOG(LogPersistenceBenchmark, Error, TEXT("The baseline %s %s results, but this run %s"), bInBaseline ? TEXT("has") : TEXT("doesn't have"), ModeField, bInCurrent ? TEXT("does") : TEXT("doesn't"));
+			NumFailures++;
+		}
+	}
+
+	TMap<FString, FString> BaselineScenarios;
+	GatherBaselineScenarios(Baseline, FString(), BaselineScenarios);
+
+	TMap<FString, FString> CurrentScenarios;
+	GatherBaselineScenarios(Current, FString(), CurrentScenarios);
+
+	for (const TPair<FString, FString>& Scenario : BaselineScenarios)
+	{
+		const FString* CurrentScenario = CurrentScenarios.Find(Scenario.Key);
+
+		if (CurrentScenario != nullptr && *CurrentScenario != Scenario.Value)
+		{
+			UE_LOG(LogPersistenceBenchmark, Error, TEXT("%s doesn't match the baseline (baseline %s, current %s)"), *Scenario.Key, *Scenario.Value, **CurrentScenario);
+			NumFailures++;
+		}
+	}
+
+	TArray<FPersistenceBaselineMetric> BaselineMetrics;
+	GatherBaselineMetrics(Baseline, FString(), BaselineMetrics);
+
+	TArray<FPersistenceBaselineMetric> CurrentMetrics;
+	GatherBaselineMetrics(Current, FString(), CurrentMetrics);
+
+	TMap<FString, double> CurrentLookup;
+	for (const FPersistenceBaselineMetric& Metric : CurrentMetrics)
+	{
+		CurrentLookup.Add(Metric.Name, Metric.Value);
+	}
+
+	const TSharedPtr<FJsonObject>* Tolerances = nullptr;
+	Baseline.TryGetObjectField(TEXT("Tolerances"), Tolerances);
+
+	UE_LOG(LogPersistenceBenchmark, Display, TEXT("  %-56s %12s %12s %9s  %s"), TEXT("Metric"), TEXT("Baseline"), TEXT("Current"), TEXT("Change"), TEXT("Status"));
+
+	for (const FPersistenceBaselineMetric& Metric : BaselineMetrics)
+	{
+		const double* CurrentValue = CurrentLookup.Find(Metric.Name);
+
+		// A benchmark that was dropped, or didn't get far enough to report this, can't be allowed to pass
+		if (CurrentValue == nullptr)
+		{
+			UE_LOG(LogPersistenceBenchmark, Display, TEXT("  %-56s %12.3f %12s %9s  MISSING"), *Metric.Name, Metric.Value, TEXT("-"), TEXT("-"));
+			NumFailures++;
+			continue;
+		}
+
+		const double Delta = *CurrentValue - Metric.Value;
+		const double Change = Metric.Value > 0.0 ? Delta / Metric.Value : 0.0;
+
+		const TCHAR* Status = TEXT("ok");
+
+		if (Metric.bIsCount)
+		{
+			if (*CurrentValue != Metric.Value)
+			{
+				Status = TEXT("CHANGED");
+				NumFailures++;
+			}
+		}
+		else
+		{
+			double Tolerance = DefaultTolerance;
+
+			if (Tolerances != nullptr)
+			{
+				int32 DotIndex = INDEX_NONE;
+				const FString StageName = Metric.Name.FindLastChar(TEXT('.'), DotIndex) ? Metric.Name.RightChop(DotIndex + 1) : Metric.Name;
+
+				if (!(*Tolerances)->TryGetNumberField(Metric.Name, Tolerance))
+				{
+					(*Tolerances)->TryGetNumberField(StageName, Tolerance);
+				}
+			}
+
+			// Differences below MinDelta are ignored, since tiny timings are too noisy for a relative tolerance to mean much
+			if (Delta > MinDelta && Change > Tolerance)
+			{
+				Status = TEXT("REGRESSED");
+				NumFailures++;
+			}
+			else if (-Delta > MinDelta && -Change > Tolerance)
+			{
+				Status = TEXT("improved");
+			}
+		}
+
+		UE_LOG(LogPersistenceBenchmark, Display, TEXT("  %-56s %12.3f %12.3f %+8.1f%%  %s"), *Metric.Name, Metric.Value, *CurrentValue, Change * 100.0, Status);
+	}
+
+	return NumFailures;
+}
+
+int32 UPersistenceBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 Iterations = 5;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Persistence") / FString::Printf(TEXT("Benchmark-%s.json"), *FDateTime::Now().ToString());
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	int32 ExitCode = 0;
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetStringField(TEXT("Build"), FApp::GetBuildVersion());
+	Json->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Json->SetNumberField(TEXT("Iterations"), Iterations);
+
+	FPersistenceBenchmarkScenario Scenario;
+	Scenario.Parse(*Params);
+
+	FString RoundTripDirectory;
+	const bool bRoundTrip = FParse::Value(*Params, TEXT("RoundTrip="), RoundTripDirectory) || FParse::Param(*Params, TEXT("RoundTrip"));
+
+	if (bRoundTrip)
+	{
+		TSharedRef<FJsonObject> RoundTripJson = MakeShared<FJsonObject>();
+
+		const bool bSuccess = RunRoundTripBenchmarks(Scenario, RoundTripDirectory, Iterations, *RoundTripJson);
+
+		Json->SetObjectField(TEXT("RoundTrip"), RoundTripJson);
+
+		// Still write out the results when a save fails, so it's easy to see which one it was
+		if (!bSuccess)
+		{
+			ExitCode = 1;
+		}
+	}
+	else if (FParse::Param(*Params, TEXT("Micro")))
+	{
+		TSharedRef<FJsonObject> MicroJson = MakeShared<FJsonObject>();
+
+		UE_LOG(LogPersistenceBenchmark, Display, TEXT("Micro benchmarks:"));
+
+		if (!RunMicroBenchmarks(Scenario.Seed, Iterations, *MicroJson))
+		{
+			return 1;
+		}
+
+		Json->SetObjectField(TEXT("Micro"), MicroJson);
+	}
+	else if (FParse::Param(*Params, TEXT("IO")))
+	{
+		TSharedRef<FJsonObject> IOJson = MakeShared<FJsonObject>();
+
+		UE_LOG(LogPersistenceBenchmark, Display, TEXT("I/O benchmarks (%s engine):"), FPersistenceIOEngine::Get().GetName());
+
+		if (!RunIOBenchmarks(Scenario.Seed, Iterations, FParse::Param(*Params, TEXT("Flush")), *IOJson))
+		{
+			return 1;
+		}
+
+		Json->SetObjectField(TEXT("IO"), IOJson);
+	}
+	else if (FParse::Param(*Params, TEXT("Reference")))
+	{
+		TSharedRef<FJsonObject> ReferenceJson = MakeShared<FJsonObject>();
+
+		for (const TPair<FString, FPersistenceBenchmarkScenario>& Reference : GetReferenceScenarios(Scenario.Seed))
+		{
+			FPersistenceBenchmarkResults Results;
+			if (!RunWorldBenchmark(Reference.Value, Iterations, Results))
+			{
+				return 1;
+			}
+
+			UE_LOG(LogPersistenceBenchmark, Display, TEXT("Reference scenario %s:"), *Reference.Key);
+			Results.Log();
+
+			TSharedRef<FJsonObject> ScenarioJson = MakeShared<FJsonObject>();
+			ScenarioJson->SetObjectField(TEXT("Scenario"), Reference.Value.ToJson());
+			ScenarioJson->SetObjectField(TEXT("Results"), Results.ToJson());
+			ReferenceJson->SetObjectField(Reference.Key, ScenarioJson);
+		}
+
+		Json->SetObjectField(TEXT("Reference"), ReferenceJson);
+	}
+	else
+	{
+		FPersistenceBenchmarkResults Results;
+		if (!RunWorldBenchmark(Scenario, Iterations, Results))
+		{
+			return 1;
+		}
+
+		UE_LOG(LogPersistenceBenchmark, Display, TEXT("World benchmark (%d levels, %d actors per level):"), Scenario.NumLevels, Scenario.ActorsPerLevel);
+		Results.Log();
+
+		TSharedRef<FJsonObject> WorldJson = MakeShared<FJsonObject>();
+		WorldJson->SetObjectField(TEXT("Scenario"), Scenario.ToJson());
+		WorldJson->SetObjectField(TEXT("Results"), Results.ToJson());
+		Json->SetObjectField(TEXT("World"), WorldJson);
+	}
+
+	FString Output;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	FJsonSerializer::Serialize(Json, Writer);
+
+	if (!FFileHelper::SaveStringToFile(Output, *OutputPath))
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't write benchmark results to '%s'"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogPersistenceBenchmark, Display, TEXT("Wrote benchmark results to '%s'"), *OutputPath);
+
+	FString BaselinePath;
+	if (FParse::Value(*Params, TEXT("Baseline="), BaselinePath))
+	{
+		double Tolerance = 0.1;
+		FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+		double MinDelta = 0.1;
+		FParse::Value(*Params, TEXT("MinDelta="), MinDelta);
+
+		FString BaselineString;
+		TSharedPtr<FJsonObject> BaselineJson;
+
+		if (!FFileHelper::LoadFileToString(BaselineString, *BaselinePath) ||
+			!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineString), BaselineJson) ||
+			!BaselineJson.IsValid())
+		{
+			UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't read baseline '%s'"), *BaselinePath);
+			return 1;
+		}
+
+		const int32 NumFailures = CompareToBaseline(*BaselineJson, *Json, Tolerance, MinDelta);
+
+		if (NumFailures > 0)
+		{
+			UE_LOG(LogPersistenceBenchmark, Error, TEXT("%d check(s) failed against baseline '%s'"), NumFailures, *BaselinePath);
+			ExitCode = 1;
+		}
+		else
+		{
+			UE_LOG(LogPersistenceBenchmark, Display, TEXT("No regressions against baseline '%s'"), *BaselinePath);
+		}
+	}
+
+	return ExitCode;
+}
+
+UPersistenceManager* UPersistenceBenchmarkCommandlet::CreateWorld()
+{
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->InitializeStandalone();
+
+	UPersistenceManager* Manager = GameInstance->GetSubsystem<UPersistenceManager>();
+
+	if (Manager != nullptr)
+	{
+		// Leaves no slot selected, which keeps commits from writing to storage. The save is written separately so it can
+		// be timed on its own.
+		Manager->SetCurrentSaveForTesting(nullptr);
+	}
+
+	return Manager;
+}
+
+void UPersistenceBenchmarkCommandlet::DestroyWorld()
+{
+	if (GameInstance != nullptr)
+	{
+		UWorld* World = GameInstance->GetWorld();
+
+		GameInstance->Shutdown();
+
+		if (World != nullptr)
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		GameInstance = nullptr;
+	}
+
+	CollectGarbage(RF_NoFlags);
+}
+
+void UPersistenceBenchmarkCommandlet::WaitForSaves(UPersistenceManager& Manager)
+{
+	while (Manager.IsSaving())
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FPlatformProcess::Sleep(0.001f);
+	}
+}
+
+void UPersistenceBenchmarkCommandlet::SpawnScenario(const FPersistenceBenchmarkScenario& Scenario, UPersistenceManager& Manager, TArray<FPersistenceBenchmarkActorInfo>& OutActors)
+{
+	UWorld* World = GameInstance->GetWorld();
+	ULevel* Level = World->PersistentLevel;
+
+	FRandomStream Random(Scenario.Seed);
+
+	OutActors.Reserve(Scenario.NumLevels * Scenario.ActorsPerLevel);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 LevelIndex = 0; LevelIndex < Scenario.NumLevels; LevelIndex++)
+	{
+		const FName ContainerKey(*FString::Printf(TEXT("PersistenceBenchmark_Level%d"), LevelIndex));
+
+		// All the actors are really in the persistent level, so stand in for each level loading in turn to get them
+		// registered to their own container.
+		Manager.SetLevelContainerForTesting(Level, ContainerKey);
+
+		for (int32 ActorIndex = 0; ActorIndex < Scenario.ActorsPerLevel; ActorIndex++)
+		{
+			const FVector Location(Random.FRandRange(-10000.f, 10000.f), Random.FRandRange(-10000.f, 10000.f), Random.FRandRange(0.f, 1000.f));
+			const FTransform Transform(FRotator(0.f, Random.FRand() * 360.f, 0.f), Location);
+
+			APersistenceBenchmarkActor* Actor = World->SpawnActor<APersistenceBenchmarkActor>(APersistenceBenchmarkActor::StaticClass(), Transform, SpawnParams);
+			Actor->Setup(Random, Scenario.ComponentsPerActor, Scenario.SubobjectDepth);
+
+			UPersistenceComponent* Persistence = Actor->GetPersistenceComponent();
+			Persistence->PersistTransform = Random.FRand() < Scenario.TransformFraction;
+			Persistence->SetDynamicForTesting(Random.FRand() < Scenario.DynamicFraction);
+
+			Manager.Register(Persistence);
+
+			if (!Persistence->IsDynamic && Random.FRand() < Scenario.DestroyedFraction)
+			{
+				Manager.SetComponentDestroyed(Persistence);
+				Manager.Unregister(Persistence);
+				Actor->Destroy();
+			}
+			else
+			{
+				OutActors.Add({ Actor, ContainerKey });
+			}
+		}
+	}
+}
+
+bool UPersistenceBenchmarkCommandlet::RunWorldBenchmark(const FPersistenceBenchmarkScenario& Scenario, int32 Iterations, FPersistenceBenchmarkResults& Results)
+{
+	UPersistenceManager* Manager = CreateWorld();
+	if (Manager == nullptr)
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't create a persistence manager for the benchmark world"));
+		DestroyWorld();
+		return false;
+	}
+
+	UWorld* World = GameInstance->GetWorld();
+	ULevel* Level = World->PersistentLevel;
+
+	TArray<FPersistenceBenchmarkActorInfo> Actors;
+	SpawnScenario(Scenario, *Manager, Actors);
+
+	TArray<AActor*> SpawnedActors;
+	const FDelegateHandle SpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateLambda([&SpawnedActors](AActor* Actor)
+	{
+		SpawnedActors.Add(Actor);
+	}));
+
+	bool bSuccess = true;
+
+	for (int32 Iteration = 0; Iteration < Iterations && bSuccess; Iteration++)
+	{
+		// The whole commit, which writes every container then hands the save off to the persistence thread
+		double StartTime = FPlatformTime::Seconds();
+		Manager->CommitSave(TEXT("Benchmark"));
+		Results.Add(TEXT("CommitMs"), MillisecondsSince(StartTime));
+
+		WaitForSaves(*Manager);
+
+		// Just the container writes
+		StartTime = FPlatformTime::Seconds();
+		Manager->WriteContainersForTesting();
+		Results.Add(TEXT("ContainerWriteMs"), MillisecondsSince(StartTime));
+
+		TArray<uint8> SaveBlob;
+
+		StartTime = FPlatformTime::Seconds();
+		Manager->WriteSaveForTesting(Manager->GetCurrentSave(), SaveBlob);
+		Results.Add(TEXT("WriteSaveMs"), MillisecondsSince(StartTime));
+		Results.Add(TEXT("SaveBytes"), SaveBlob.Num());
+
+		const TSharedRef<FPersistenceSaveData> SaveData = MakeShared<FPersistenceSaveData>(MoveTemp(SaveBlob));
+
+		EPersistenceLoadResult LoadResult = EPersistenceLoadResult::Success;
+
+		StartTime = FPlatformTime::Seconds();
+		USaveGameWorld* LoadedSave = Cast<USaveGameWorld>(Manager->ReadSaveForTesting(SaveData, LoadResult));
+		Results.Add(TEXT("ReadSaveMs"), MillisecondsSince(StartTime));
+
+		if (LoadedSave == nullptr)
+		{
+			UE_LOG(LogPersistenceBenchmark, Error, TEXT("Benchmark save failed to load"));
+			bSuccess = false;
+			break;
+		}
+
+		// Swap in the save we just read, the same as loading a slot would
+		Manager->SetCurrentSaveForTesting(LoadedSave);
+
+		StartTime = FPlatformTime::Seconds();
+		for (const TSharedPtr<FPersistenceContainer>& Container : LoadedSave->GetContainers())
+		{
+			Container->Unpack();
+		}
+		Results.Add(TEXT("UnpackMs"), MillisecondsSince(StartTime));
+
+		// A full collection with the save loaded, which also cleans up the save it replaced
+		StartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		Results.Add(TEXT("CollectGarbageMs"), MillisecondsSince(StartTime));
+
+		// Load the data back into the actors that are still around
+		StartTime = FPlatformTime::Seconds();
+		for (const FPersistenceBenchmarkActorInfo& BenchmarkActor : Actors)
+		{
+			if (FPersistenceContainer* Container = Manager->FindContainerForTesting(BenchmarkActor.ContainerKey))
+			{
+				Container->LoadData(BenchmarkActor.Actor->GetPersistenceComponent(), *Manager);
+			}
+		}
+		Results.Add(TEXT("LoadDataMs"), MillisecondsSince(StartTime));
+
+		// Spawn copies of all the dynamic actors, which also loads their data
+		StartTime = FPlatformTime::Seconds();
+		for (const TSharedPtr<FPersistenceContainer>& Container : LoadedSave->GetContainers())
+		{
+			Manager->SetLevelContainerForTesting(Level, Container->GetKey());
+			Container->SpawnDynamicActorsForTesting(Level, *Manager);
+		}
+		Results.Add(TEXT("SpawnDynamicMs"), MillisecondsSince(StartTime));
+		Results.Add(TEXT("DynamicActorsSpawned"), SpawnedActors.Num());
+
+		for (AActor* SpawnedActor : SpawnedActors)
+		{
+			SpawnedActor->Destroy();
+		}
+		SpawnedActors.Reset();
+	}
+
+	World->RemoveOnActorSpawnedHandler(SpawnedHandle);
+
+	DestroyWorld();
+
+	return bSuccess;
+}
+
+bool UPersistenceBenchmarkCommandlet::RunMicroBenchmarks(int32 Seed, int32 Iterations, FJsonObject& Results)
+{
+	UPersistenceManager* Manager = CreateWorld();
+	if (Manager == nullptr)
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't create a persistence manager for the benchmark world"));
+		DestroyWorld();
+		return false;
+	}
+
+	UWorld* World = GameInstance->GetWorld();
+
+	FRandomStream Random(Seed);
+
+	const int32 ArchiveVersion = FSaveGameArchive::GetLatestVersion();
+
+	// Names like the ones objects and components end up with, about half of them numbered
+	TArray<FName> Names;
+	Names.Reserve(MicroNumOps);
+
+	for (int32 i = 0; i < MicroNumOps; i++)
+	{
+		const int32 NameIndex = Random.RandHelper(MicroNumUniqueNames);
+		Names.Add(FName(*FString::Printf(TEXT("BenchmarkName_%d"), NameIndex), (NameIndex & 1) ? Random.RandRange(1, 64) : 0));
+	}
+
+	// FSaveGameArchive << FName
+	{
+		TArray<uint8> Buffer;
+		FNameCache NameCache;
+
+		RunMicroBenchmark(Results, TEXT("NameWrite"), Iterations, [&](int64& OutBytes)
+		{
+			Buffer.Reset();
+			NameCache.Reset();
+
+			FMemoryWriter Writer(Buffer);
+			FSaveGameArchive Ar(Writer, NameCache, ArchiveVersion);
+
+			for (FName& Name : Names)
+			{
+				Ar.SerializeNameForTesting(Name);
+			}
+
+			OutBytes = Buffer.Num();
+			return Names.Num();
+		});
+
+		RunMicroBenchmark(Results, TEXT("NameRead"), Iterations, [&](int64& OutBytes)
+		{
+			FMemoryReader Reader(Buffer);
+			FSaveGameArchive Ar(Reader, NameCache, ArchiveVersion);
+
+			FName Name;
+			for (int32 i = 0; i < Names.Num(); i++)
+			{
+				Ar.SerializeNameForTesting(Name);
+			}
+
+			OutBytes = Buffer.Num();
+			return Names.Num();
+		});
+	}
+
+	// FSaveGameArchive << UObject*, referencing objects from a large graph
+	{
+		TArray<UObject*> GraphObjects;
+		GraphObjects.Reserve(MicroNumGraphObjects);
+
+		for (int32 i = 0; i < MicroNumGraphObjects; i++)
+		{
+			GraphObjects.Add(NewObject<UPersistenceBenchmarkObject>(GameInstance));
+		}
+
+		TArray<UObject*> References;
+		References.Reserve(MicroNumOps);
+
+		for (int32 i = 0; i < MicroNumOps; i++)
+		{
+			References.Add(GraphObjects[Random.RandHelper(MicroNumGraphObjects)]);
+		}
+
+		TArray<uint8> Buffer;
+		FNameCache NameCache;
+
+		RunMicroBenchmark(Results, TEXT("ObjectRefWrite"), Iterations, [&](int64& OutBytes)
+		{
+			Buffer.Reset();
+
+			FMemoryWriter Writer(Buffer);
+			FSaveGameArchive Ar(Writer, NameCache, ArchiveVersion);
+
+			for (UObject* Reference : References)
+			{
+				Ar.SerializeObjectForTesting(Reference);
+			}
+
+			OutBytes = Buffer.Num();
+			return References.Num();
+		});
+	}
+
+	// FNameCache
+	{
+		FNameCache NameCache;
+
+		RunMicroBenchmark(Results, TEXT("NameCacheAdd"), Iterations, [&](int64& OutBytes)
+		{
+			NameCache.Reset();
+
+			for (const FName& Name : Names)
+			{
+				NameCache.AddName(Name);
+			}
+
+			return Names.Num();
+		});
+
+		TArray<uint8> Buffer;
+
+		RunMicroBenchmark(Results, TEXT("NameCacheSerializeWrite"), Iterations, [&](int64& OutBytes)
+		{
+			Buffer.Reset();
+
+			FMemoryWriter Writer(Buffer);
+			NameCache.Serialize(Writer);
+
+			OutBytes = Buffer.Num();
+			return MicroNumUniqueNames;
+		});
+
+		RunMicroBenchmark(Results, TEXT("NameCacheSerializeRead"), Iterations, [&](int64& OutBytes)
+		{
+			FNameCache LoadedCache;
+
+			FMemoryReader Reader(Buffer);
+			LoadedCache.Serialize(Reader);
+
+			OutBytes = Buffer.Num();
+			return MicroNumUniqueNames;
+		});
+	}
+
+	// Everything below needs an actor to work with, with lots of components and a deep chain of subobjects
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	APersistenceBenchmarkActor* Actor = World->SpawnActor<APersistenceBenchmarkActor>(APersistenceBenchmarkActor::StaticClass(), FTransform::Identity, SpawnParams);
+	Actor->Setup(Random, MicroNumComponents, MicroSubobjectDepth);
+
+	TArray<UPersistenceBenchmarkComponent*> Components;
+	Actor->GetComponents(Components);
+
+	TMap<FName, bool> ClassCache;
+
+	// FSaveGameArchive::WriteObjectAndLength, which seeks back to patch the length after every object
+	{
+		TArray<uint8> Buffer;
+		FNameCache NameCache;
+
+		RunMicroBenchmark(Results, TEXT("WriteObjectAndLength"), Iterations, [&](int64& OutBytes)
+		{
+			Buffer.Reset();
+
+			FMemoryWriter Writer(Buffer);
+			FSaveGameArchive Ar(Writer, NameCache, ArchiveVersion);
+
+			for (int32 i = 0; i < MicroNumObjectWrites; i++)
+			{
+				Ar.WriteObjectAndLengthForTesting(Components[i % Components.Num()]);
+			}
+
+			OutBytes = Buffer.Num();
+			return MicroNumObjectWrites;
+		});
+	}
+
+	// FSaveGameArchive::GetClassesToLoad
+	{
+		TArray<uint8> Buffer;
+		FNameCache NameCache;
+
+		{
+			FMemoryWriter Writer(Buffer);
+			FSaveGameArchive Ar(Writer, NameCache, ArchiveVersion);
+			Ar.WriteBaseObject(Actor, ClassCache);
+		}
+
+		TArray<FSoftObjectPath> ClassesToLoad;
+
+		RunMicroBenchmark(Results, TEXT("GetClassesToLoad"), Iterations, [&](int64& OutBytes)
+		{
+			FMemoryReader Reader(Buffer);
+			FSaveGameArchive Ar(Reader, NameCache, ArchiveVersion);
+
+			const int32 NumCalls = 1000;
+
+			for (int32 i = 0; i < NumCalls; i++)
+			{
+				ClassesToLoad.Reset();
+				Ar.GetClassesToLoad(ClassesToLoad);
+			}
+
+			OutBytes = static_cast<int64>(Buffer.Num()) * NumCalls;
+			return NumCalls;
+		});
+	}
+
+	// FSaveGameArchive::ReadComponents, which matches each saved component to the actor's components by name
+	{
+		TArray<uint8> Buffer;
+		FNameCache NameCache;
+
+		{
+			FMemoryWriter Writer(Buffer);
+			FSaveGameArchive Ar(Writer, NameCache, ArchiveVersion);
+			Ar.WriteComponentsForTesting(Actor, ClassCache);
+		}
+
+		RunMicroBenchmark(Results, TEXT("ReadComponents"), Iterations, [&](int64& OutBytes)
+		{
+			FMemoryReader Reader(Buffer);
+			FSaveGameArchive Ar(Reader, NameCache, ArchiveVersion);
+
+			const int32 NumCalls = 1000;
+
+			for (int32 i = 0; i < NumCalls; i++)
+			{
+				Ar.SeekForTesting(0);
+				Ar.ReadComponentsForTesting(Actor);
+			}
+
+			OutBytes = static_cast<int64>(Buffer.Num()) * NumCalls;
+			return NumCalls;
+		});
+	}
+
+	// FSaveHeader::Read, which is dominated by checksumming the whole save
+	{
+		TArray<uint8> Payload;
+		Payload.SetNumUninitialized(MicroHeaderPayloadBytes);
+
+		for (uint8& Byte : Payload)
+		{
+			Byte = static_cast<uint8>(Random.RandHelper(256));
+		}
+
+		// Take the header values from a real save, so it'll pass validation
+		TArray<uint8> Buffer;
+		Manager->WriteSaveForTesting(Manager->GetCurrentSave(), Buffer);
+
+		if (!UPersistenceManager::ReplaceSavePayloadForTesting(Buffer, Payload))
+		{
+			UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't read back the header of a benchmark save"));
+			DestroyWorld();
+			return false;
+		}
+
+		RunMicroBenchmark(Results, TEXT("SaveHeaderRead"), Iterations, [&](int64& OutBytes)
+		{
+			const int32 NumCalls = 8;
+
+			for (int32 i = 0; i < NumCalls; i++)
+			{
+				verify(UPersistenceManager::ReadSaveHeaderForTesting(MakeMemoryView(Buffer)) == EPersistenceLoadResult::Success);
+			}
+
+			OutBytes = static_cast<int64>(Buffer.Num()) * NumCalls;
+			return NumCalls;
+		});
+	}
+
+	Actor->Destroy();
+
+	DestroyWorld();
+
+	return true;
+}
+
+bool UPersistenceBenchmarkCommandlet::RunIOBenchmarks(int32 Seed, int32 Iterations, bool bFlush, FJsonObject& Results)
+{
+	FRandomStream Random(Seed);
+
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("Persistence/IOBenchmark");
+
+	TArray<TArray<uint8>> WriteData;
+	TArray<TArray<uint8>> ReadData;
+	WriteData.SetNum(IONumFiles);
+	ReadData.SetNum(IONumFiles);
+
+	for (TArray<uint8>& Data : WriteData)
+	{
+		Data.SetNumUninitialized(IOFileBytes);
+
+		for (uint8& Byte : Data)
+		{
+			Byte = static_cast<uint8>(Random.RandHelper(256));
+		}
+	}
+
+	TArray<FPersistenceIORequest> Writes;
+	TArray<FPersistenceIORequest> Reads;
+
+	for (int32 i = 0; i < IONumFiles; i++)
+	{
+		const FString Path = Directory / FString::Printf(TEXT("File%d.bin"), i);
+
+		FPersistenceIORequest& Write = Writes.AddDefaulted_GetRef();
+		Write.Type = FPersistenceIORequest::EType::Write;
+		Write.Path = Path;
+		Write.WriteData = WriteData[i];
+		Write.bFlush = bFlush;
+
+		FPersistenceIORequest& Read = Reads.AddDefaulted_GetRef();
+		Read.Type = FPersistenceIORequest::EType::Read;
+		Read.Path = Path;
+		Read.ReadData = &ReadData[i];
+	}
+
+	bool bSuccess = true;
+
+	// Each batch is the whole set of files, so the blocking engine does them one after another and the platform's
+	// engine gets to have them all in flight at once
+	auto RunEngine = [&](FPersistenceIOEngine& Engine, const TCHAR* Prefix)
+	{
+		RunMicroBenchmark(Results, *FString::Printf(TEXT("%sWrite"), Prefix), Iterations, [&](int64& OutBytes)
+		{
+			bSuccess &= Engine.Execute(Writes);
+
+			OutBytes = static_cast<int64>(IONumFiles) * IOFileBytes;
+			return IONumFiles;
+		});
+
+		RunMicroBenchmark(Results, *FString::Printf(TEXT("%sRead"), Prefix), Iterations, [&](int64& OutBytes)
+		{
+			bSuccess &= Engine.Execute(Reads);
+
+			OutBytes = static_cast<int64>(IONumFiles) * IOFileBytes;
+			return IONumFiles;
+		});
+
+		for (int32 i = 0; i < IONumFiles; i++)
+		{
+			if (ReadData[i] != WriteData[i])
+			{
+				UE_LOG(LogPersistenceBenchmark, Error, TEXT("%s engine read back different data for '%s'"), Engine.GetName(), *Reads[i].Path);
+				bSuccess = false;
+			}
+
+			ReadData[i].Reset();
+		}
+	};
+
+	RunEngine(FPersistenceIOEngine::GetBlocking(), TEXT("Blocking"));
+	RunEngine(FPersistenceIOEngine::Get(), TEXT("Engine"));
+
+	Results.SetStringField(TEXT("Engine"), FPersistenceIOEngine::Get().GetName());
+	Results.SetBoolField(TEXT("Flush"), bFlush);
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("I/O benchmark failed to read or write its files in '%s'"), *Directory);
+	}
+
+	return bSuccess;
+}
+
+bool UPersistenceBenchmarkCommandlet::RunRoundTripBenchmarks(const FPersistenceBenchmarkScenario& Scenario, const FString& Directory, int32 Iterations, FJsonObject& Results)
+{
+	UPersistenceManager* Manager = CreateWorld();
+	if (Manager == nullptr)
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't create a persistence manager for the benchmark world"));
+		DestroyWorld();
+		return false;
+	}
+
+	bool bSuccess = true;
+
+	if (Directory.IsEmpty())
+	{
+		// Without a directory of saves, write one out from a synthetic world
+		TArray<FPersistenceBenchmarkActorInfo> Actors;
+		SpawnScenario(Scenario, *Manager, Actors);
+
+		Manager->WriteContainersForTesting();
+
+		TArray<uint8> SaveBlob;
+		Manager->WriteSaveForTesting(Manager->GetCurrentSave(), SaveBlob);
+
+		bSuccess = RoundTripSave(*Manager, TEXT("Synthetic"), MakeShared<FPersistenceSaveData>(MoveTemp(SaveBlob)), Iterations, Results);
+	}
+	else
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(Directory / TEXT("*.sav")), true, false);
+
+		if (Files.Num() == 0)
+		{
+			UE_LOG(LogPersistenceBenchmark, Error, TEXT("No saves found in '%s'"), *Directory);
+			bSuccess = false;
+		}
+
+		for (const FString& File : Files)
+		{
+			// Map the save the same way the file save system would, and fall back to reading it if that's not possible
+			TSharedPtr<FPersistenceSaveData> SaveData = FPersistenceSaveData::MapFile(*(Directory / File));
+
+			if (!SaveData.IsValid())
+			{
+				TArray<uint8> SaveBlob;
+				if (!FFileHelper::LoadFileToArray(SaveBlob, *(Directory / File)))
+				{
+					UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't read save '%s'"), *File);
+					bSuccess = false;
+					continue;
+				}
+
+				SaveData = MakeShared<FPersistenceSaveData>(MoveTemp(SaveBlob));
+			}
+
+			if (!RoundTripSave(*Manager, File, SaveData.ToSharedRef(), Iterations, Results))
+			{
+				bSuccess = false;
+			}
+		}
+	}
+
+	DestroyWorld();
+
+	return bSuccess;
+}
+
+bool UPersistenceBenchmarkCommandlet::RoundTripSave(UPersistenceManager& Manager, const FString& Name, const TSharedRef<const FPersistenceSaveData>& SaveData, int32 Iterations, FJsonObject& Results)
+{
+	const TArrayView<const uint8> SaveBlob(static_cast<const uint8*>(SaveData->GetView().GetData()), static_cast<int32>(SaveData->Num()));
+
+	UWorld* World = GameInstance->GetWorld();
+
+	// Every actor record is loaded into the same stand in actor. Properties it doesn't have are skipped over, so this
+	// still reads through all the data in the record even when the real actor class isn't around.
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	APersistenceBenchmarkActor* DummyActor = World->SpawnActor<APersistenceBenchmarkActor>(APersistenceBenchmarkActor::StaticClass(), FTransform::Identity, SpawnParams);
+	UPersistenceComponent* DummyComponent = DummyActor->GetPersistenceComponent();
+
+	FPersistenceBenchmarkResults Stages;
+
+	int32 NumContainers = 0;
+	int32 NumRecords = 0;
+	SIZE_T PackedBytes = 0;
+	SIZE_T UnpackedBytes = 0;
+	TArray<uint8> RewrittenBlob;
+
+	bool bLoaded = true;
+
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		double StartTime = FPlatformTime::Seconds();
+		bLoaded = UPersistenceManager::ReadSaveHeaderForTesting(SaveData->GetView()) == EPersistenceLoadResult::Success;
+		Stages.Add(TEXT("HeaderReadMs"), MillisecondsSince(StartTime));
+
+		if (!bLoaded)
+		{
+			break;
+		}
+
+		EPersistenceLoadResult LoadResult = EPersistenceLoadResult::Success;
+
+		StartTime = FPlatformTime::Seconds();
+		USaveGame* LoadedSave = Manager.ReadSaveForTesting(SaveData, LoadResult);
+		Stages.Add(TEXT("ReadSaveMs"), MillisecondsSince(StartTime));
+
+		if (LoadedSave == nullptr)
+		{
+			bLoaded = false;
+			break;
+		}
+
+		USaveGameWorld* LoadedWorld = Cast<USaveGameWorld>(LoadedSave);
+
+		NumContainers = 0;
+		NumRecords = 0;
+		PackedBytes = 0;
+		UnpackedBytes = 0;
+
+		// Profile saves don't have any containers, so there's nothing to unpack or load for them
+		if (LoadedWorld != nullptr)
+		{
+			const TConstArrayView<TSharedPtr<FPersistenceContainer>> Containers = LoadedWorld->GetContainers();
+
+			StartTime = FPlatformTime::Seconds();
+			for (const TSharedPtr<FPersistenceContainer>& Container : Containers)
+			{
+				Container->Unpack();
+			}
+			Stages.Add(TEXT("UnpackMs"), MillisecondsSince(StartTime));
+
+			// Gather the actor ids up front, so only the loads are timed
+			TArray<TArray<FGuid>> ActorIds;
+			ActorIds.SetNum(Containers.Num());
+
+			for (int32 i = 0; i < Containers.Num(); i++)
+			{
+				Containers[i]->GetActorIdsForTesting(ActorIds[i]);
+			}
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Containers.Num(); i++)
+			{
+				for (const FGuid& ActorId : ActorIds[i])
+				{
+					DummyComponent->SetUniqueIdForTesting(ActorId);
+					Containers[i]->LoadData(DummyComponent, Manager);
+				}
+			}
+			Stages.Add(TEXT("LoadDataMs"), MillisecondsSince(StartTime));
+
+			for (int32 i = 0; i < Containers.Num(); i++)
+			{
+				NumContainers++;
+				NumRecords += ActorIds[i].Num();
+				PackedBytes += Containers[i]->GetPackedSize();
+				UnpackedBytes += Containers[i]->GetUnpackedSize();
+			}
+		}
+
+		StartTime = FPlatformTime::Seconds();
+		Manager.WriteSaveForTesting(LoadedSave, RewrittenBlob);
+		Stages.Add(TEXT("WriteSaveMs"), MillisecondsSince(StartTime));
+	}
+
+	DummyActor->Destroy();
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetBoolField(TEXT("Loaded"), bLoaded);
+	Json->SetNumberField(TEXT("Bytes"), SaveBlob.Num());
+	Json->SetBoolField(TEXT("Mapped"), SaveData->IsMapped());
+
+	if (!bLoaded)
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("Round trip '%s' failed to load"), *Name);
+		Results.SetObjectField(Name, Json);
+		return false;
+	}
+
+	// Nothing about the save was changed, so writing it back out should give us exactly what we read in
+	int32 FirstDifference = INDEX_NONE;
+
+	for (int32 i = 0; i < FMath::Min(SaveBlob.Num(), RewrittenBlob.Num()); i++)
+	{
+		if (SaveBlob[i] != RewrittenBlob[i])
+		{
+			FirstDifference = i;
+			break;
+		}
+	}
+
+	if (FirstDifference == INDEX_NONE && SaveBlob.Num() != RewrittenBlob.Num())
+	{
+		FirstDifference = FMath::Min(SaveBlob.Num(), RewrittenBlob.Num());
+	}
+
+	const bool bIdentical = FirstDifference == INDEX_NONE;
+
+	UE_LOG(LogPersistenceBenchmark, Display, TEXT("Round trip '%s' (%d bytes, %d containers, %d records):"), *Name, SaveBlob.Num(), NumContainers, NumRecords);
+	Stages.Log();
+
+	UE_CLOG(!bIdentical, LogPersistenceBenchmark, Error, TEXT("Round trip '%s' rewrote %d bytes that first differ at offset %d"), *Name, RewrittenBlob.Num(), FirstDifference);
+
+	Json->SetNumberField(TEXT("RewrittenBytes"), RewrittenBlob.Num());
+	Json->SetNumberField(TEXT("Containers"), NumContainers);
+	Json->SetNumberField(TEXT("Records"), NumRecords);
+	Json->SetNumberField(TEXT("PackedBytes"), PackedBytes);
+	Json->SetNumberField(TEXT("UnpackedBytes"), UnpackedBytes);
+	Json->SetBoolField(TEXT("Identical"), bIdentical);
+	Json->SetNumberField(TEXT("FirstDifference"), FirstDifference);
+	Json->SetObjectField(TEXT("Results"), Stages.ToJson());
+
+	Results.SetObjectField(Name, Json);
+
+	return bIdentical;
+}
@@ -0,0 +1,83 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "PersistenceBenchmarkCommandlet.generated.h"
+
+struct FPersistenceBenchmarkScenario;
+struct FPersistenceBenchmarkResults;
+struct FPersistenceBenchmarkActorInfo;
+class FPersistenceSaveData;
+class FJsonObject;
+
+//
+// Benchmarks the save system against a synthetic world, and writes the results out as JSON so they can be compared
+// from one change to the next. Everything runs headless, so this can be run on build agents.
+//
+// Usage: -run=PersistenceBenchmark -nullrhi [-Output=<file>] [-Iterations=5] [-Seed=1] [-Micro] [-IO [-Flush]]
+//        [-RoundTrip[=<dir>]] [-Reference] [-Baseline=<file>] [-Tolerance=0.1] [-MinDelta=0.1]
+//        [-Levels=10] [-Actors=200] [-Components=2] [-Depth=1] [-Dynamic=0.25] [-Destroyed=0.05] [-Transform=0.5]
+//
+// Levels is the number of containers, and Actors is the number of actors in each of them. Every actor gets Components
+// saved components and a subobject chain Depth deep. Dynamic, Destroyed and Transform are the fraction of actors that
+// are dynamically spawned, that are placed but destroyed, and that persist their transform.
+//
+// The results include the time for the whole commit, the container writes, writing the save, reading it back in,
+// unpacking the containers, a full garbage collection with the save loaded, loading actors, and spawning dynamic
+// actors, along with the size of the save.
+//
+// With -Micro, the individual serialization primitives (name and object references, the name cache, object writes,
+// class gathering, component reads and the header checksum) are benchmarked instead, reporting ns per operation and
+// MB/s. Each is run Iterations times and the fastest run is reported, since that's the least noisy for short runs.
+//
+// With -IO, a batch of large files is written and read back with blocking I/O and then with the platform's I/O engine
+// (io_uring on Linux), reporting MB/s for each. With -Flush, every file is flushed to storage as it would be for a save.
+//
+// With -RoundTrip, every .sav file in the directory (or a save from the synthetic world if no directory is given) is
+// mapped (or read, if it can't be), unpacked, loaded into a stand in actor, and written back out, timing each stage. The
+// rewritten save has to match the original byte for byte, otherwise the commandlet fails. Saves from older formats or
+// builds are upgraded when they're rewritten, so they're expected to fail that check.
+//
+// With -Reference, a fixed set of world scenarios are run instead of the one from the command line. These are meant to
+// be checked against a baseline.
+//
+// With -Baseline, the results are compared to an earlier run's output and a table of the differences is printed. If
+// any timed stage median or micro benchmark time got worse by more than Tolerance (a fraction) and by more than
+// MinDelta (in the metric's units), the commandlet fails. Counts such as SaveBytes must match the baseline exactly, and
+// the run fails if it's missing any of the baseline's metrics or used a different mode or scenario. To update a
+// baseline, copy a new run's output over it. A baseline can add a Tolerances object to override the tolerance for
+// noisy metrics, see CompareToBaseline.
+//
+UCLASS()
+class UPersistenceBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	bool RunWorldBenchmark(const FPersistenceBenchmarkScenario& Scenario, int32 Iterations, FPersistenceBenchmarkResults& Results);
+	bool RunMicroBenchmarks(int32 Seed, int32 Iterations, FJsonObject& Results);
+	bool RunIOBenchmarks(int32 Seed, int32 Iterations, bool bFlush, FJsonObject& Results);
+	bool RunRoundTripBenchmarks(const FPersistenceBenchmarkScenario& Scenario, const FString& Directory, int32 Iterations, FJsonObject& Results);
+
+	// Reads a save, unpacks and loads everything in it, then writes it back out and checks it's unchanged. Returns false
+	// if the save couldn't be read or it didn't write back out the same.
+	bool RoundTripSave(UPersistenceManager& Manager, const FString& Name, const TSharedRef<const FPersistenceSaveData>& SaveData, int32 Iterations, FJsonObject& Results);
+
+	// Creates a game world with a persistence manager. Returns null if the manager couldn't be created.
+	UPersistenceManager* CreateWorld();
+	void DestroyWorld();
+
+	// Pumps the game thread until the persistence thread has finished with all the saves we've committed
+	static void WaitForSaves(UPersistenceManager& Manager);
+
+	// Spawns and registers the synthetic actors for a scenario. Actors that were destroyed aren't returned.
+	void SpawnScenario(const FPersistenceBenchmarkScenario& Scenario, UPersistenceManager& Manager, TArray<FPersistenceBenchmarkActorInfo>& OutActors);
+
+	UPROPERTY(Transient)
+	TObjectPtr<UGameInstance> GameInstance;
+};
@@ -0,0 +1,54 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceSizeReportCommandlet.h"
+
+#include "GunfireSaveSystemBenchmark.h"
+#include "PersistenceManager.h"
+#include "PersistenceSizeReport.h"
+
+#include "Misc/FileHelper.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PersistenceSizeReportCommandlet)
+
+int32 UPersistenceSizeReportCommandlet::Main(const FString& Params)
+{
+	FString FilePath;
+	if (!FParse::Value(*Params, TEXT("File="), FilePath))
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("No save file specified, use -File=<save file>"));
+		return 1;
+	}
+
+	TArray<uint8> SaveBlob;
+	if (!FFileHelper::LoadFileToArray(SaveBlob, *FilePath))
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't load '%s'"), *FilePath);
+		return 1;
+	}
+
+	FPersistenceSizeReport Report;
+	if (!UPersistenceManager::DescribeSave(SaveBlob, Report))
+	{
+		UE_LOG(LogPersistenceBenchmark, Error, TEXT("'%s' isn't a valid save"), *FilePath);
+		return 1;
+	}
+
+	int32 MaxEntries = 20;
+	FParse::Value(*Params, TEXT("Max="), MaxEntries);
+
+	Report.Dump(*GLog, MaxEntries);
+
+	FString CsvPath;
+	if (FParse::Value(*Params, TEXT("Csv="), CsvPath))
+	{
+		if (!FFileHelper::SaveStringToFile(Report.ToCsv(), *CsvPath))
+		{
+			UE_LOG(LogPersistenceBenchmark, Error, TEXT("Couldn't write '%s'"), *CsvPath);
+			return 1;
+		}
+
+		UE_LOG(LogPersistenceBenchmark, Display, TEXT("Wrote size report to '%s'"), *CsvPath);
+	}
+
+	return 0;
+}
@@ -0,0 +1,25 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "PersistenceSizeReportCommandlet.generated.h"
+
+//
+// Prints a breakdown of where the bytes in a save file are going, by container, actor class, component, subobject class
+// and property.
+//
+// Usage: -run=PersistenceSizeReport -File=<save file> [-Csv=<output file>] [-Max=<entries per category>]
+//
+// Placed actors are reported under a generic name, since their class is only known when their level is loaded. Use the
+// SaveSystem.SizeReport console command in game to get those broken down.
+//
+UCLASS()
+class UPersistenceSizeReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
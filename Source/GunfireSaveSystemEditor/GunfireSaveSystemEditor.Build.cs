@@ -0,0 +1,28 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Editor only tools for the save system, like the commandlet that builds the persistent actor manifests for maps before
+// cooking. This is an editor module, so none of it ends up in game builds.
+public class GunfireSaveSystemEditor : ModuleRules
+{
+	public GunfireSaveSystemEditor(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"AssetRegistry",
+				"CoreUObject",
+				"Engine",
+				"GunfireSaveSystem",
+			}
+		);
+	}
+}
@@ -0,0 +1,9 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "GunfireSaveSystemEditor.h"
+
+#include "Modules/ModuleManager.h"
+
+DEFINE_LOG_CATEGORY(LogPersistenceEditor);
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, GunfireSaveSystemEditor)
@@ -0,0 +1,152 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#include "PersistenceManifestCommandlet.h"
+
+#include "GunfireSaveSystemEditor.h"
+#include "PersistenceComponent.h"
+#include "PersistenceLevelManifest.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PersistenceManifestCommandlet)
+
+int32 UPersistenceManifestCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	const bool bReset = Switches.Contains(TEXT("Reset"));
+
+	TArray<FString> MapPackages;
+
+	if (const FString* Maps = ParamVals.Find(TEXT("Maps")))
+	{
+		Maps->ParseIntoArray(MapPackages, TEXT("+"));
+	}
+	else
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.SearchAllAssets(true);
+
+		TArray<FAssetData> MapAssets;
+		AssetRegistry.GetAssetsByClass(UWorld::StaticClass()->GetClassPathName(), MapAssets);
+
+		for (const FAssetData& MapAsset : MapAssets)
+		{
+			FNameBuilder PackageName(MapAsset.PackageName);
+			if (PackageName.ToView().StartsWith(TEXT("/Game/")))
+			{
+				MapPackages.Emplace(PackageName.ToString());
+			}
+		}
+	}
+
+	MapPackages.Sort();
+
+	int32 NumFailed = 0;
+
+	for (const FString& MapPackage : MapPackages)
+	{
+		if (!ProcessMap(MapPackage, bReset))
+		{
+			NumFailed++;
+		}
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	UE_LOG(LogPersistenceEditor, Display, TEXT("Processed %d maps, %d failed"), MapPackages.Num(), NumFailed);
+
+	return NumFailed > 0 ? 1 : 0;
+}
+
+bool UPersistenceManifestCommandlet::ProcessMap(const FString& PackageName, bool bReset)
+{
+	UPackage* Package = LoadPackage(nullptr, *PackageName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+
+	if (World == nullptr || World->PersistentLevel == nullptr)
+	{
+		UE_LOG(LogPersistenceEditor, Error, TEXT("Failed to load map '%s'"), *PackageName);
+		return false;
+	}
+
+	// The runtime cells for partitioned worlds are generated during cook, and containers are keyed by those cells, so
+	// a manifest on the editor level wouldn't match anything at runtime.
+	if (World->IsPartitionedWorld())
+	{
+		UE_LOG(LogPersistenceEditor, Display, TEXT("Skipping '%s', world partition maps aren't supported"), *PackageName);
+		return true;
+	}
+
+	ULevel* Level = World->PersistentLevel;
+
+	// Gather all the placed actors that will store their data in this level's container
+	TArray<TPair<FGuid, FSoftClassPath>> Actors;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		const UPersistenceComponent* Component = Actor->FindComponentByClass<UPersistenceComponent>();
+
+		if (Component && Component->GetUniqueId().IsValid() && Component->GetSaveKey().IsNone())
+		{
+			Actors.Emplace(Component->GetUniqueId(), FSoftClassPath(Actor->GetClass()));
+		}
+	}
+
+	UPersistenceLevelManifest* Manifest = Level->GetAssetUserData<UPersistenceLevelManifest>();
+
+	if (Manifest == nullptr)
+	{
+		// Don't add an empty manifest to levels that don't have any persistent actors
+		if (Actors.Num() == 0)
+		{
+			return true;
+		}
+
+		Manifest = NewObject<UPersistenceLevelManifest>(Level, NAME_None, RF_Transactional);
+		Level->AddAssetUserData(Manifest);
+	}
+
+	if (!Manifest->Update(Actors, bReset))
+	{
+		UE_LOG(LogPersistenceEditor, Display, TEXT("Manifest for '%s' is up to date (%d actors)"), *PackageName, Manifest->NumActors());
+		return true;
+	}
+
+	const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetMapPackageExtension());
+
+	if (IFileManager::Get().IsReadOnly(*Filename))
+	{
+		UE_LOG(LogPersistenceEditor, Error, TEXT("Can't update manifest for '%s', file is read only"), *Filename);
+		return false;
+	}
+
+	Package->MarkPackageDirty();
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Standalone;
+
+	if (!UPackage::SavePackage(Package, World, *Filename, SaveArgs))
+	{
+		UE_LOG(LogPersistenceEditor, Error, TEXT("Failed to save '%s'"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogPersistenceEditor, Display, TEXT("Updated manifest for '%s' (%d actors)"), *PackageName, Manifest->NumActors());
+
+	return true;
+}
@@ -0,0 +1,29 @@
+// Copyright Gunfire Games, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "PersistenceManifestCommandlet.generated.h"
+
+//
+// Generates or updates the persistent actor manifest (UPersistenceLevelManifest) for maps. This should be run before
+// cooking whenever placed persistent actors are added to a level, and the updated maps checked in.
+//
+// Usage: -run=PersistenceManifest [-Maps=/Game/Maps/A+/Game/Maps/B] [-Reset]
+//
+// If no maps are specified, every map under /Game is processed. -Reset discards the existing manifests instead of
+// appending to them, which will drop the destroyed state stored against them in existing saves.
+//
+UCLASS()
+class UPersistenceManifestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	// Returns true if the map was processed successfully (even if it didn't need to change)
+	bool ProcessMap(const FString& PackageName, bool bReset);
+};